@@ -0,0 +1,43 @@
+// Buffers shared by the mesh shaders. DrawData is per-surface data for
+// GPU-driven rendering and mirrors GPUDrawData in mesh.hpp
+
+struct Vertex {
+    vec3 position;
+    float uv_x;
+    vec3 normal;
+    float uv_y;
+    vec4 color;
+};
+
+layout(buffer_reference, std430) readonly buffer VertexBuffer {
+    Vertex vertices[];
+};
+
+// World matrix per object, indexed by objectIndex
+layout(buffer_reference, std430) readonly buffer TransformBuffer {
+    mat4 transforms[];
+};
+
+// Transform buffer slot per instance, indexed by gl_InstanceIndex
+layout(buffer_reference, std430) readonly buffer InstanceBuffer {
+    uint objects[];
+};
+
+struct DrawData {
+    vec4 boundingSphere; // world space: xyz center, w radius
+    VertexBuffer vertexBuffer;
+    uint indexCount;
+    uint firstIndex;
+    uint batch;          // slot in the count buffer
+    uint commandOffset;  // first command of the batch
+    int vertexOffset;    // mesh's first vertex in the geometry arena
+    uint materialIndex;  // slot in the bindless material buffer
+    uint objectIndex;    // slot in the transform buffer
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+layout(buffer_reference, std430) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
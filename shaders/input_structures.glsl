@@ -7,10 +7,24 @@ layout(set = 0, binding = 0) uniform SceneData {
     vec4 sunlightColor;
 } sceneData;
 
-layout(set = 1, binding = 0) uniform GLTFMaterialData{
+// Bindless materials; mirrors BindlessTable & GPUMaterial in bindless.hpp.
+// Requires GL_EXT_nonuniform_qualifier: indices may differ within a draw.
+layout(set = 1, binding = 0) uniform texture2D textures[];
+layout(set = 1, binding = 1) uniform sampler samplers[];
+
+struct Material {
     vec4 colorFactors;
     vec4 metallicRoughnessFactors;
-} materialData;
+    uint colorTexture;
+    uint colorSampler;
+    uint metallicRoughnessTexture;
+    uint metallicRoughnessSampler;
+};
+
+layout(set = 1, binding = 2, std430) readonly buffer MaterialBuffer {
+    Material materials[];
+};
 
-layout(set = 1, binding = 1) uniform sampler2D colorTex;
-layout(set = 1, binding = 2) uniform sampler2D metallicRoughnessTex;
\ No newline at end of file
+vec4 sampleTexture(uint textureIndex, uint samplerIndex, vec2 uv) {
+    return texture(sampler2D(textures[nonuniformEXT(textureIndex)], samplers[nonuniformEXT(samplerIndex)]), uv);
+}
\ No newline at end of file
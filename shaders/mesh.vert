@@ -2,38 +2,34 @@
 
 #extension GL_GOOGLE_include_directive : require
 #extension GL_EXT_buffer_reference : require
+#extension GL_EXT_nonuniform_qualifier : require
 
 #include "input_structures.glsl"
+#include "draw_structures.glsl"
 
 layout(location = 0) out vec3 outNormal;
 layout(location = 1) out vec3 outColor;
 layout(location = 2) out vec2 outUV;
-
-struct Vertex {
-    vec3 position;
-    float uv_x;
-    vec3 normal;
-    float uv_y;
-    vec4 color;
-};
-
-layout(buffer_reference, std430) readonly buffer VertexBuffer {
-    Vertex vertices[];
-};
+layout(location = 3) flat out uint outMaterial;
 
 layout(push_constant) uniform constants {
-    mat4 renderMatrix;
     VertexBuffer vertexBuffer;
+    TransformBuffer transformBuffer;
+    InstanceBuffer instanceBuffer;
+    uint materialIndex;
 } PushConstants;
 
 void main() {
     Vertex v = PushConstants.vertexBuffer.vertices[gl_VertexIndex];
+    uint objectIndex = PushConstants.instanceBuffer.objects[gl_InstanceIndex];
+    mat4 transform = PushConstants.transformBuffer.transforms[objectIndex];
 
     vec4 position = vec4(v.position, 1.0f);
-    gl_Position = sceneData.viewproj * PushConstants.renderMatrix * position;
+    gl_Position = sceneData.viewproj * transform * position;
 
-    outNormal = (PushConstants.renderMatrix * vec4(v.normal, 0.0f)).xyz;
-    outColor = v.color.xyz * materialData.colorFactors.xyz;
+    outNormal = (transform * vec4(v.normal, 0.0f)).xyz;
+    outColor = v.color.xyz * materials[PushConstants.materialIndex].colorFactors.xyz;
     outUV.x = v.uv_x;
     outUV.y = v.uv_y;
+    outMaterial = PushConstants.materialIndex;
 }
\ No newline at end of file
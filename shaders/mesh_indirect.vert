@@ -0,0 +1,35 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_nonuniform_qualifier : require
+
+#include "input_structures.glsl"
+#include "draw_structures.glsl"
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec2 outUV;
+layout(location = 3) flat out uint outMaterial;
+
+// Shares the layout of mesh.vert; the vertex buffer slot holds the draw data
+// address, and the object & material indices come from the draw data
+layout(push_constant) uniform constants {
+    DrawDataBuffer drawData;
+    TransformBuffer transformBuffer;
+} PushConstants;
+
+void main() {
+    DrawData draw = PushConstants.drawData.draws[gl_InstanceIndex];
+    Vertex v = draw.vertexBuffer.vertices[gl_VertexIndex];
+    mat4 transform = PushConstants.transformBuffer.transforms[draw.objectIndex];
+
+    vec4 position = vec4(v.position, 1.0f);
+    gl_Position = sceneData.viewproj * transform * position;
+
+    outNormal = (transform * vec4(v.normal, 0.0f)).xyz;
+    outColor = v.color.xyz * materials[draw.materialIndex].colorFactors.xyz;
+    outUV.x = v.uv_x;
+    outUV.y = v.uv_y;
+    outMaterial = draw.materialIndex;
+}
@@ -0,0 +1,270 @@
+#include <engine.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+#include <glm/gtc/constants.hpp>
+
+/**
+ * Per-frame sample recorded by the benchmark. All times are in milliseconds.
+ */
+struct FrameSample {
+    uint32_t frame;
+    float frameTime;
+    float sceneUpdateTime;
+    float meshDrawTime;
+    float submitTime;
+    float presentTime;
+    float fenceWaitTime;
+    float gpuFrameTime;
+    float cpuGpuOverlap;
+    int drawCallCount;
+    int triangleCount;
+    int visibleCount;
+    int culledCount;
+    float gpuPassTimes[GPU_PASS_COUNT];
+};
+
+static FrameSample sampleFrame(const JVKEngine &engine, const uint32_t frame) {
+    FrameSample s;
+    s.frame           = frame;
+    s.frameTime       = engine.stats_.frameTime;
+    s.sceneUpdateTime = engine.stats_.sceneUpdateTime;
+    s.meshDrawTime    = engine.stats_.meshDrawTime;
+    s.submitTime      = engine.stats_.submitTime;
+    s.presentTime     = engine.stats_.presentTime;
+    s.fenceWaitTime   = engine.stats_.fenceWaitTime;
+    s.gpuFrameTime    = engine.stats_.gpuFrameTime;
+    s.cpuGpuOverlap   = engine.stats_.cpuGpuOverlap;
+    s.drawCallCount   = engine.stats_.drawCallCount;
+    s.triangleCount   = engine.stats_.triangleCount;
+    s.visibleCount    = engine.stats_.visibleCount;
+    s.culledCount     = engine.stats_.culledCount;
+    for (uint32_t i = 0; i < GPU_PASS_COUNT; ++i) {
+        s.gpuPassTimes[i] = engine.stats_.gpuPassTimes[i];
+    }
+    return s;
+}
+
+static void writeCSV(std::ostream &out, const std::vector<FrameSample> &samples) {
+    out << "frame,frame_ms,update_scene_ms,draw_geometry_ms,submit_ms,present_ms,fence_wait_ms,gpu_frame_ms,overlap,draws,triangles,visible,culled";
+    for (const char *pass: GPU_PASS_NAMES) {
+        out << ",gpu_" << pass << "_ms";
+    }
+    out << "\n";
+
+    for (const FrameSample &s: samples) {
+        out << fmt::format("{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.3f},{},{},{},{}",
+                           s.frame, s.frameTime, s.sceneUpdateTime, s.meshDrawTime, s.submitTime, s.presentTime,
+                           s.fenceWaitTime, s.gpuFrameTime, s.cpuGpuOverlap, s.drawCallCount, s.triangleCount, s.visibleCount, s.culledCount);
+        for (const float t: s.gpuPassTimes) {
+            out << fmt::format(",{:.4f}", t);
+        }
+        out << "\n";
+    }
+}
+
+static void writeJSON(std::ostream &out, const std::vector<FrameSample> &samples) {
+    out << "[\n";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const FrameSample &s = samples[i];
+        out << fmt::format("  {{\"frame\": {}, \"frame_ms\": {:.4f}, \"update_scene_ms\": {:.4f}, \"draw_geometry_ms\": {:.4f}, "
+                           "\"submit_ms\": {:.4f}, \"present_ms\": {:.4f}, \"fence_wait_ms\": {:.4f}, \"gpu_frame_ms\": {:.4f}, "
+                           "\"overlap\": {:.3f}, \"draws\": {}, \"triangles\": {}, \"visible\": {}, \"culled\": {}",
+                           s.frame, s.frameTime, s.sceneUpdateTime, s.meshDrawTime, s.submitTime, s.presentTime,
+                           s.fenceWaitTime, s.gpuFrameTime, s.cpuGpuOverlap, s.drawCallCount, s.triangleCount, s.visibleCount, s.culledCount);
+        for (uint32_t p = 0; p < GPU_PASS_COUNT; ++p) {
+            out << fmt::format(", \"gpu_{}_ms\": {:.4f}", GPU_PASS_NAMES[p], s.gpuPassTimes[p]);
+        }
+        out << (i + 1 < samples.size() ? "},\n" : "}\n");
+    }
+    out << "]\n";
+}
+
+static void printSummary(const char *name, std::vector<float> values) {
+    if (values.empty()) return;
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (const float v: values) sum += v;
+
+    const auto percentile = [&](const float p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+    fmt::println("{:<18} mean {:8.4f}  p50 {:8.4f}  p95 {:8.4f}  p99 {:8.4f}  max {:8.4f} ms",
+                 name, sum / values.size(), percentile(0.5f), percentile(0.95f), percentile(0.99f), values.back());
+}
+
+// Usage: jvk_bench [--frames N] [--warmup N] [--scene path.glb] [--path camera.txt]
+//                  [--width W] [--height H] [--out samples.csv|samples.json] [--window]
+//                  [--sort state|depth] [--cpu-driven] [--no-instancing]
+//                  [--pacing low-latency|default|max-throughput] [--frames-in-flight N] [--no-cache]
+int main(int argc, char **argv) {
+    JVKEngine engine;
+    engine.headless_ = true;
+
+    uint32_t frameCount  = 1000;
+    uint32_t warmupCount = 60;
+    std::string pathFile;
+    std::string outPath = "bench.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--window") {
+            engine.headless_ = false;
+            continue;
+        }
+        if (arg == "--cpu-driven") {
+            engine.gpuDrivenRendering_ = false;
+            continue;
+        }
+        if (arg == "--no-instancing") {
+            engine.instancing_ = false;
+            continue;
+        }
+        if (arg == "--no-cache") {
+            engine.assetCache_ = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fmt::println(stderr, "Missing value for argument: {}", arg);
+            return 1;
+        }
+
+        if (arg == "--frames") {
+            frameCount = std::stoul(argv[++i]);
+        } else if (arg == "--warmup") {
+            warmupCount = std::stoul(argv[++i]);
+        } else if (arg == "--scene") {
+            engine.scenePath_ = argv[++i];
+        } else if (arg == "--path") {
+            pathFile = argv[++i];
+        } else if (arg == "--width") {
+            engine.windowExtent_.width = std::stoul(argv[++i]);
+        } else if (arg == "--height") {
+            engine.windowExtent_.height = std::stoul(argv[++i]);
+        } else if (arg == "--out") {
+            outPath = argv[++i];
+        } else if (arg == "--pacing") {
+            const std::string preset = argv[++i];
+            if (preset == "low-latency") {
+                engine.frameCount_  = JVK_PACING_LOW_LATENCY.frameCount;
+                engine.presentMode_ = JVK_PACING_LOW_LATENCY.presentMode;
+            } else if (preset == "default") {
+                engine.frameCount_  = JVK_PACING_DEFAULT.frameCount;
+                engine.presentMode_ = JVK_PACING_DEFAULT.presentMode;
+            } else if (preset == "max-throughput") {
+                engine.frameCount_  = JVK_PACING_MAX_THROUGHPUT.frameCount;
+                engine.presentMode_ = JVK_PACING_MAX_THROUGHPUT.presentMode;
+            } else {
+                fmt::println(stderr, "Unknown pacing preset: {}", preset);
+                return 1;
+            }
+        } else if (arg == "--frames-in-flight") {
+            engine.frameCount_ = std::clamp(static_cast<uint32_t>(std::stoul(argv[++i])), 1u, JVK_MAX_FRAMES);
+        } else if (arg == "--sort") {
+            const std::string mode = argv[++i];
+            if (mode == "state") {
+                engine.drawSortMode_ = DrawSortMode::STATE;
+            } else if (mode == "depth") {
+                engine.drawSortMode_ = DrawSortMode::FRONT_TO_BACK;
+            } else {
+                fmt::println(stderr, "Unknown sort mode: {}", mode);
+                return 1;
+            }
+        } else {
+            fmt::println(stderr, "Unknown argument: {}", arg);
+            return 1;
+        }
+    }
+
+    // CAMERA PATH
+    // Default: a full turn in place from the engine's start position
+    CameraPath path;
+    if (pathFile.empty()) {
+        path.keyframes.push_back({0.0f, glm::vec3(30.f, 0.f, -85.f), 0.0f, 0.0f});
+        path.keyframes.push_back({static_cast<float>(frameCount), glm::vec3(30.f, 0.f, -85.f), 0.0f, glm::two_pi<float>()});
+    } else {
+        auto loaded = CameraPath::load(pathFile);
+        if (!loaded.has_value()) {
+            fmt::println(stderr, "Failed to load camera path: {}", pathFile);
+            return 1;
+        }
+        path = *loaded;
+    }
+
+    engine.init();
+
+    // WARMUP
+    // Pipelines, descriptor pools & driver caches settle in; camera held at the first keyframe
+    for (uint32_t i = 0; i < warmupCount; ++i) {
+        if (!engine.headless_ && !engine.processEvents()) break;
+        path.apply(engine.mainCamera_, 0.0f);
+        engine.frame();
+    }
+
+    // MEASURE
+    std::vector<FrameSample> samples;
+    samples.reserve(frameCount);
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        if (!engine.headless_ && !engine.processEvents()) break;
+        path.apply(engine.mainCamera_, static_cast<float>(i));
+        engine.frame();
+        samples.push_back(sampleFrame(engine, i));
+    }
+
+    // Rolling over the last frames, so read before cleanup
+    LatencyPercentiles latencies[3];
+    engine.latency_.percentiles(latencies[0], latencies[1], latencies[2]);
+    const bool presentWait = engine.presentWaitSupported_;
+
+    engine.cleanup();
+
+    // OUTPUT
+    std::ofstream out(outPath);
+    if (!out.is_open()) {
+        fmt::println(stderr, "Failed to open output: {}", outPath);
+        return 1;
+    }
+
+    if (outPath.ends_with(".json")) {
+        writeJSON(out, samples);
+    } else {
+        writeCSV(out, samples);
+    }
+    fmt::println("Wrote {} frames to {}", samples.size(), outPath);
+
+    const auto column = [&](float FrameSample::*member) {
+        std::vector<float> values;
+        values.reserve(samples.size());
+        for (const FrameSample &s: samples) values.push_back(s.*member);
+        return values;
+    };
+    printSummary("frame", column(&FrameSample::frameTime));
+    printSummary("updateScene", column(&FrameSample::sceneUpdateTime));
+    printSummary("drawGeometry", column(&FrameSample::meshDrawTime));
+    printSummary("submit", column(&FrameSample::submitTime));
+    printSummary("present", column(&FrameSample::presentTime));
+    printSummary("fence wait", column(&FrameSample::fenceWaitTime));
+    printSummary("gpu frame", column(&FrameSample::gpuFrameTime));
+
+    double overlap = 0.0;
+    for (const FrameSample &s: samples) overlap += s.cpuGpuOverlap;
+    if (!samples.empty()) {
+        fmt::println("{:<18} mean {:7.1f}%", "cpu/gpu overlap", 100.0 * overlap / samples.size());
+    }
+
+    // Headless frames never see input and are timed to GPU completion
+    const char *latencyNames[3] = {"input latency", "simulation latency", "submit latency"};
+    fmt::println("Latency until {} over the last {} frames:", presentWait ? "presentation" : "GPU completion", JVK_LATENCY_WINDOW);
+    for (uint32_t i = 0; i < 3; ++i) {
+        fmt::println("{:<18} p50 {:8.4f}  p95 {:8.4f}  p99 {:8.4f}  max {:8.4f} ms",
+                     latencyNames[i], latencies[i].p50, latencies[i].p95, latencies[i].p99, latencies[i].max);
+    }
+    for (uint32_t p = 0; p < GPU_PASS_COUNT; ++p) {
+        std::vector<float> values;
+        values.reserve(samples.size());
+        for (const FrameSample &s: samples) values.push_back(s.gpuPassTimes[p]);
+        printSummary(fmt::format("gpu {}", GPU_PASS_NAMES[p]).c_str(), values);
+    }
+
+    return 0;
+}
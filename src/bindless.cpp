@@ -0,0 +1,122 @@
+#include <bindless.hpp>
+#include <engine.hpp>
+
+void BindlessTable::init(JVKEngine *engine) {
+    device_    = engine->ctx_.device;
+    allocator_ = engine->allocator_;
+
+    // CAPACITY
+    VkPhysicalDeviceVulkan12Properties properties12{};
+    properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(engine->ctx_, &properties);
+
+    const uint32_t textureCapacity = std::min(JVK_MAX_BINDLESS_TEXTURES, properties12.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    const uint32_t samplerCapacity = std::min(JVK_MAX_BINDLESS_SAMPLERS, properties12.maxPerStageDescriptorUpdateAfterBindSamplers);
+
+    textures.init(textureCapacity);
+    samplers.init(samplerCapacity);
+    materials.init(JVK_MAX_MATERIALS);
+
+    // LAYOUT
+    // Empty slots are never read, and new slots can be written while frames are in flight
+    constexpr VkDescriptorBindingFlags arrayFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                    VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                    VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    const VkDescriptorBindingFlags bindingFlags[] = {arrayFlags, arrayFlags, 0};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount  = 3;
+    flagsInfo.pBindingFlags = bindingFlags;
+
+    jvk::DescriptorLayoutBuilder builder;
+    builder.addBinding(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, textureCapacity);
+    builder.addBinding(1, VK_DESCRIPTOR_TYPE_SAMPLER, samplerCapacity);
+    builder.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    layout = builder.build(device_, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, &flagsInfo, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+    // POOL & SET
+    const VkDescriptorPoolSize poolSizes[] = {
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, textureCapacity},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, samplerCapacity},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets       = 1;
+    poolInfo.poolSizeCount = 3;
+    poolInfo.pPoolSizes    = poolSizes;
+    VK_CHECK(vkCreateDescriptorPool(device_, &poolInfo, nullptr, &pool));
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &layout;
+    VK_CHECK(vkAllocateDescriptorSets(device_, &allocInfo, &set));
+
+    // MATERIAL BUFFER
+    materialBuffer = engine->createBuffer(JVK_MAX_MATERIALS * sizeof(GPUMaterial), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+    jvk::DescriptorWriter writer;
+    writer.writeBuffer(2, materialBuffer.buffer, JVK_MAX_MATERIALS * sizeof(GPUMaterial), 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.updateSet(device_, set);
+}
+
+void BindlessTable::destroy(const JVKEngine *engine) const {
+    engine->destroyBuffer(materialBuffer);
+    vkDestroyDescriptorPool(device_, pool, nullptr);
+    vkDestroyDescriptorSetLayout(device_, layout, nullptr);
+}
+
+uint32_t BindlessTable::allocateSlot(RangeAllocator &slots, const char *name) {
+    const uint32_t slot = slots.allocate(1);
+    if (slot == RangeAllocator::INVALID) {
+        fmt::println("Bindless table is out of {} slots ({} / {})", name, slots.used(), slots.capacity());
+        abort();
+    }
+    return slot;
+}
+
+uint32_t BindlessTable::addTexture(const VkImageView imageView) {
+    const uint32_t slot = allocateSlot(textures, "texture");
+
+    jvk::DescriptorWriter writer;
+    writer.writeImage(0, imageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, slot);
+    writer.updateSet(device_, set);
+    return slot;
+}
+
+uint32_t BindlessTable::addSampler(const VkSampler sampler) {
+    const uint32_t slot = allocateSlot(samplers, "sampler");
+
+    jvk::DescriptorWriter writer;
+    writer.writeImage(1, VK_NULL_HANDLE, sampler, VK_IMAGE_LAYOUT_UNDEFINED, VK_DESCRIPTOR_TYPE_SAMPLER, slot);
+    writer.updateSet(device_, set);
+    return slot;
+}
+
+uint32_t BindlessTable::addMaterial(const GPUMaterial &material) {
+    const uint32_t slot = allocateSlot(materials, "material");
+
+    static_cast<GPUMaterial *>(materialBuffer.info.pMappedData)[slot] = material;
+    VK_CHECK(vmaFlushAllocation(allocator_, materialBuffer.allocation, slot * sizeof(GPUMaterial), sizeof(GPUMaterial)));
+    return slot;
+}
+
+void BindlessTable::freeTexture(const uint32_t index) {
+    textures.free(index, 1);
+}
+
+void BindlessTable::freeSampler(const uint32_t index) {
+    samplers.free(index, 1);
+}
+
+void BindlessTable::freeMaterial(const uint32_t index) {
+    materials.free(index, 1);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <jvk.hpp>
+#include <jvk/buffer.hpp>
+#include <geometry.hpp>
+
+class JVKEngine;
+
+// Upper bounds of the bindless arrays; textures & samplers are further
+// clamped to the device's update-after-bind limits
+constexpr uint32_t JVK_MAX_BINDLESS_TEXTURES = 4096;
+constexpr uint32_t JVK_MAX_BINDLESS_SAMPLERS = 256;
+constexpr uint32_t JVK_MAX_MATERIALS         = 4096;
+
+/**
+ * One material in the bindless material buffer; textures & samplers are
+ * slots in the bindless arrays (see Material in shaders/input_structures.glsl)
+ */
+struct GPUMaterial {
+    glm::vec4 colorFactors;
+    glm::vec4 metallicRoughnessFactors;
+    uint32_t colorTexture;
+    uint32_t colorSampler;
+    uint32_t metallicRoughnessTexture;
+    uint32_t metallicRoughnessSampler;
+};
+static_assert(sizeof(GPUMaterial) == 48, "GPUMaterial must match the std430 layout of Material");
+
+/**
+ * The material descriptor set (set 1), bound once for every draw:
+ *  0. sampled images (partially bound, update-after-bind)
+ *  1. samplers (partially bound, update-after-bind)
+ *  2. the material buffer, indexed by MaterialInstance::materialIndex
+ *
+ * Slots are reused once freed. Freeing does not wait for the GPU: no
+ * in-flight frame may still read a slot when it is freed.
+ */
+struct BindlessTable {
+    VkDescriptorSetLayout layout;
+    VkDescriptorPool pool;
+    VkDescriptorSet set;
+
+    // Host-visible, written once per material
+    jvk::Buffer materialBuffer;
+
+    RangeAllocator textures;
+    RangeAllocator samplers;
+    RangeAllocator materials;
+
+    void init(JVKEngine *engine);
+    void destroy(const JVKEngine *engine) const;
+
+    // Each returns the new slot; running out of slots aborts
+    uint32_t addTexture(VkImageView imageView);
+    uint32_t addSampler(VkSampler sampler);
+    uint32_t addMaterial(const GPUMaterial &material);
+
+    void freeTexture(uint32_t index);
+    void freeSampler(uint32_t index);
+    void freeMaterial(uint32_t index);
+
+private:
+    VkDevice device_;
+    VmaAllocator allocator_;
+
+    static uint32_t allocateSlot(RangeAllocator &slots, const char *name);
+};
@@ -0,0 +1,350 @@
+#include <cache.hpp>
+#include <mesh.hpp>
+
+#include <jvk/util.hpp>
+
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(CookedHeader) % JVKC_ALIGNMENT == 0, "CookedHeader must keep the data section aligned");
+
+// HASHING
+// Four independent lanes, so the multiplies of consecutive words overlap
+
+constexpr uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+
+static uint64_t rotateLeft(const uint64_t x, const int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t readWord(const unsigned char *bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static uint64_t hashRound(uint64_t lane, const uint64_t word) {
+    lane += word * HASH_PRIME_2;
+    lane = rotateLeft(lane, 31);
+    return lane * HASH_PRIME_1;
+}
+
+uint64_t hashBytes(const void *data, const size_t size, const uint64_t seed) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    size_t i          = 0;
+
+    uint64_t lanes[4] = {seed + HASH_PRIME_1 + HASH_PRIME_2, seed + HASH_PRIME_2, seed, seed - HASH_PRIME_1};
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            lanes[l] = hashRound(lanes[l], readWord(bytes + i + l * 8));
+        }
+    }
+
+    uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+    hash += size;
+
+    // TAIL
+    for (; i + 8 <= size; i += 8) {
+        hash ^= hashRound(0, readWord(bytes + i));
+        hash = rotateLeft(hash, 27) * HASH_PRIME_1 + HASH_PRIME_2;
+    }
+    for (; i < size; ++i) {
+        hash ^= bytes[i] * HASH_PRIME_1;
+        hash = rotateLeft(hash, 11) * HASH_PRIME_2;
+    }
+
+    // AVALANCHE
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// MAPPED FILE
+
+bool MappedFile::open(const std::filesystem::path &path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_    = file;
+    mapping_ = mapping;
+    data_    = static_cast<const char *>(view);
+    size_    = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+
+    data_ = static_cast<const char *>(view);
+    size_ = static_cast<size_t>(fileStat.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+    file_    = nullptr;
+    mapping_ = nullptr;
+#else
+    munmap(const_cast<char *>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// WRITER
+
+static int64_t writeTime(const std::filesystem::path &path, std::error_code &ec) {
+    return std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+}
+
+bool CookedSceneWriter::open(const std::filesystem::path &path, const uint64_t sourceHash) {
+    path_     = path;
+    tempPath_ = path;
+    tempPath_ += ".tmp";
+
+    out_.open(tempPath_, std::ios::binary | std::ios::trunc);
+    if (!out_) return false;
+
+    header_            = {};
+    header_.magic      = JVKC_MAGIC;
+    header_.version    = JVKC_VERSION;
+    header_.sourceHash = sourceHash;
+
+    // Rewritten by finish(); blobs follow it directly
+    out_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+    header_.data.offset = sizeof(header_);
+    dataSize_           = 0;
+    return out_.good();
+}
+
+uint64_t CookedSceneWriter::addData(const void *data, const uint64_t size) {
+    static constexpr char padding[JVKC_ALIGNMENT] = {};
+
+    const uint64_t offset = jvk::alignUp(dataSize_, JVKC_ALIGNMENT);
+    out_.write(padding, static_cast<std::streamsize>(offset - dataSize_));
+    out_.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    dataSize_ = offset + size;
+    return offset;
+}
+
+CookedString CookedSceneWriter::addString(const std::string_view string) {
+    const CookedString cooked = {static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(string.size())};
+    strings_.append(string);
+    return cooked;
+}
+
+void CookedSceneWriter::addDependency(const std::filesystem::path &path) {
+    std::error_code ec;
+    CookedDependency dependency{};
+    dependency.path      = addString(path.string());
+    dependency.size      = std::filesystem::file_size(path, ec);
+    dependency.writeTime = writeTime(path, ec);
+    dependencies.push_back(dependency);
+}
+
+bool CookedSceneWriter::finish() {
+    static constexpr char padding[JVKC_ALIGNMENT] = {};
+
+    header_.data.count = dataSize_;
+    uint64_t position  = header_.data.offset + dataSize_;
+
+    // TABLES
+    const auto writeSection = [&](CookedSection &section, const void *records, const uint64_t count, const uint64_t recordSize) {
+        section.offset = jvk::alignUp(position, JVKC_ALIGNMENT);
+        section.count  = count;
+        out_.write(padding, static_cast<std::streamsize>(section.offset - position));
+        out_.write(static_cast<const char *>(records), static_cast<std::streamsize>(count * recordSize));
+        position = section.offset + count * recordSize;
+    };
+    const auto writeTable = [&](CookedSection &section, const auto &records) {
+        writeSection(section, records.data(), records.size(), sizeof(records[0]));
+    };
+    writeTable(header_.dependencies, dependencies);
+    writeTable(header_.samplers, samplers);
+    writeTable(header_.images, images);
+    writeTable(header_.materials, materials);
+    writeTable(header_.meshes, meshes);
+    writeTable(header_.surfaces, surfaces);
+    writeTable(header_.nodes, nodes);
+    writeSection(header_.strings, strings_.data(), strings_.size(), 1);
+
+    // HEADER
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+    out_.close();
+    if (out_.fail()) {
+        abandon();
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath_, path_, ec);
+    if (ec) {
+        abandon();
+        return false;
+    }
+    return true;
+}
+
+void CookedSceneWriter::abandon() {
+    if (out_.is_open()) {
+        out_.close();
+    }
+    std::error_code ec;
+    std::filesystem::remove(tempPath_, ec);
+}
+
+// READER
+
+bool CookedScene::open(const std::filesystem::path &path, const uint64_t sourceHash) {
+    if (!file_.open(path)) return false;
+
+    header_ = reinterpret_cast<const CookedHeader *>(file_.data());
+    if (file_.size() < sizeof(CookedHeader) || header_->magic != JVKC_MAGIC || header_->version != JVKC_VERSION || header_->sourceHash != sourceHash) {
+        file_.close();
+        return false;
+    }
+
+    if (!validate()) {
+        fmt::println("Cooked scene {} is corrupt", path.string());
+        file_.close();
+        return false;
+    }
+
+    // DEPENDENCIES
+    for (const CookedDependency &dependency: table<CookedDependency>(header_->dependencies)) {
+        const std::filesystem::path dependencyPath(string(dependency.path));
+
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(dependencyPath, ec);
+        if (ec || size != dependency.size || writeTime(dependencyPath, ec) != dependency.writeTime || ec) {
+            file_.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CookedScene::validate() const {
+    const uint64_t fileSize = file_.size();
+
+    // SECTIONS
+    const auto sectionFits = [&](const CookedSection section, const uint64_t recordSize) {
+        return section.offset % JVKC_ALIGNMENT == 0 && section.offset <= fileSize && section.count <= (fileSize - section.offset) / recordSize;
+    };
+    if (!sectionFits(header_->dependencies, sizeof(CookedDependency)) || !sectionFits(header_->samplers, sizeof(CookedSampler)) ||
+        !sectionFits(header_->images, sizeof(CookedImage)) || !sectionFits(header_->materials, sizeof(CookedMaterial)) ||
+        !sectionFits(header_->meshes, sizeof(CookedMesh)) || !sectionFits(header_->surfaces, sizeof(CookedSurface)) ||
+        !sectionFits(header_->nodes, sizeof(CookedNode)) || !sectionFits(header_->strings, 1) || !sectionFits(header_->data, 1)) {
+        return false;
+    }
+
+    // REFERENCES
+    // Blobs & strings must lie within their sections, indices within their tables
+    const auto stringFits = [&](const CookedString string) {
+        return static_cast<uint64_t>(string.offset) + string.length <= header_->strings.count;
+    };
+    const auto blobFits = [&](const uint64_t offset, const uint64_t size) {
+        return offset % JVKC_ALIGNMENT == 0 && offset <= header_->data.count && size <= header_->data.count - offset;
+    };
+    const auto indexFits = [](const uint32_t index, const uint64_t count, const bool optional) {
+        return (optional && index == JVKC_NONE) || index < count;
+    };
+
+    for (const CookedDependency &dependency: table<CookedDependency>(header_->dependencies)) {
+        if (!stringFits(dependency.path)) return false;
+    }
+    for (const CookedImage &image: images()) {
+        if (!stringFits(image.name)) return false;
+        if (image.levelCount == 0) continue;
+
+        const VkExtent2D extent = {image.extent.width, image.extent.height};
+        const VkFormat format   = static_cast<VkFormat>(image.format);
+        if (extent.width == 0 || extent.height == 0 || image.extent.depth != 1 || jvk::formatBlock(format).size == 0) return false;
+        if (image.levelCount > jvk::mipLevelCount(extent)) return false;
+        if (image.dataSize != jvk::mipChainSize(format, image.extent, image.levelCount) || !blobFits(image.dataOffset, image.dataSize)) return false;
+    }
+    for (const CookedMaterial &material: materials()) {
+        if (!stringFits(material.name) || !indexFits(material.colorImage, header_->images.count, true) ||
+            !indexFits(material.colorSampler, header_->samplers.count, true) || material.passType > static_cast<uint32_t>(MaterialPass::OTHER)) {
+            return false;
+        }
+    }
+    for (const CookedMesh &mesh: meshes()) {
+        if (!stringFits(mesh.name)) return false;
+        if (!blobFits(mesh.vertexOffset, static_cast<uint64_t>(mesh.vertexCount) * sizeof(Vertex)) ||
+            !blobFits(mesh.indexOffset, static_cast<uint64_t>(mesh.indexCount) * sizeof(uint32_t))) {
+            return false;
+        }
+        if (static_cast<uint64_t>(mesh.firstSurface) + mesh.surfaceCount > header_->surfaces.count) return false;
+
+        // Indices are uploaded as is into the shared arena, where they must not reach other meshes' vertices
+        const uint32_t *indices = static_cast<const uint32_t *>(data(mesh.indexOffset));
+        for (uint32_t i = 0; i < mesh.indexCount; ++i) {
+            if (indices[i] >= mesh.vertexCount) return false;
+        }
+
+        for (const CookedSurface &surface: surfaces().subspan(mesh.firstSurface, mesh.surfaceCount)) {
+            if (static_cast<uint64_t>(surface.startIndex) + surface.count > mesh.indexCount || !indexFits(surface.material, header_->materials.count, true)) {
+                return false;
+            }
+        }
+    }
+    for (const CookedNode &node: nodes()) {
+        if (!stringFits(node.name) || !indexFits(node.parent, header_->nodes.count, true) || !indexFits(node.meshId, header_->meshes.count, true)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <glm/vec3.hpp>
+
+// "JVKC"
+constexpr uint32_t JVKC_MAGIC = 0x434B564A;
+// Bump whenever a record below changes; files of other versions are re-cooked
+constexpr uint32_t JVKC_VERSION = 2;
+// Sections & blobs start on this alignment, so blobs can be staged and read in place
+constexpr uint64_t JVKC_ALIGNMENT = 16;
+constexpr uint32_t JVKC_NONE      = ~0u;
+
+/**
+ * Hashes size bytes of data, 32 bytes at a time. Used to key cooked files
+ * by the contents of their source; not cryptographic.
+ */
+uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0);
+
+/**
+ * A read-only memory-mapped file
+ */
+class MappedFile {
+public:
+    MappedFile() {};
+    MappedFile(MappedFile const &)            = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::filesystem::path &path);
+    void close();
+
+    const char *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_      = 0;
+#ifdef _WIN32
+    void *file_    = nullptr;
+    void *mapping_ = nullptr;
+#endif
+};
+
+// ON-DISK RECORDS
+// Plain data, written & mapped as is (little-endian). Offsets of blobs are
+// relative to the data section; strings are slices of the string section.
+
+struct CookedString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct CookedSection {
+    uint64_t offset;
+    // Records, or bytes for the string & data sections
+    uint64_t count;
+};
+
+// A file the scene was cooked from besides the source (external buffers & images)
+struct CookedDependency {
+    CookedString path;
+    uint64_t size;
+    int64_t writeTime;
+};
+
+struct CookedSampler {
+    uint32_t magFilter;
+    uint32_t minFilter;
+    uint32_t mipmapMode;
+};
+
+// The first levelCount mips in format (RGBA8 or BCn), tightly packed from mip 0 down; 0 if the image failed to decode
+struct CookedImage {
+    CookedString name;
+    VkExtent3D extent;
+    uint32_t format;
+    uint32_t levelCount;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+// Images & samplers are indices into the file's tables, or JVKC_NONE for the defaults
+struct CookedMaterial {
+    CookedString name;
+    glm::vec4 colorFactors;
+    glm::vec4 metallicRoughnessFactors;
+    uint32_t colorImage;
+    uint32_t colorSampler;
+    uint32_t passType;
+};
+
+// Vertices & indices are final: interleaved Vertex data and mesh-local uint32_t indices
+struct CookedMesh {
+    CookedString name;
+    uint32_t firstSurface;
+    uint32_t surfaceCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+};
+
+// Material is an index into the file's table, or JVKC_NONE for the engine's default
+struct CookedSurface {
+    uint32_t startIndex;
+    uint32_t count;
+    glm::vec3 origin;
+    float sphereRadius;
+    glm::vec3 extents;
+    uint32_t material;
+};
+
+// In glTF node order
+struct CookedNode {
+    CookedString name;
+    uint32_t parent;
+    uint32_t meshId;
+    glm::mat4 localTransform;
+};
+
+struct CookedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    CookedSection dependencies;
+    CookedSection samplers;
+    CookedSection images;
+    CookedSection materials;
+    CookedSection meshes;
+    CookedSection surfaces;
+    CookedSection nodes;
+    CookedSection strings;
+    CookedSection data;
+};
+
+/**
+ * Writes a cooked scene (.jvkc).
+ *
+ * Blobs are streamed to disk as they are added, so pixel & vertex data need
+ * not be kept around until the end; the tables are filled in by the caller
+ * and written by finish(). The file is written under a temporary name and
+ * only renamed into place once complete.
+ */
+struct CookedSceneWriter {
+    std::vector<CookedDependency> dependencies;
+    std::vector<CookedSampler> samplers;
+    std::vector<CookedImage> images;
+    std::vector<CookedMaterial> materials;
+    std::vector<CookedMesh> meshes;
+    std::vector<CookedSurface> surfaces;
+    std::vector<CookedNode> nodes;
+
+    bool open(const std::filesystem::path &path, uint64_t sourceHash);
+    // Appends a blob to the data section; returns its offset
+    uint64_t addData(const void *data, uint64_t size);
+    CookedString addString(std::string_view string);
+    // Records the size & write time of a file the scene depends on
+    void addDependency(const std::filesystem::path &path);
+
+    bool finish();
+    // Removes the partial file
+    void abandon();
+
+private:
+    std::filesystem::path path_;
+    std::filesystem::path tempPath_;
+    std::ofstream out_;
+    CookedHeader header_{};
+    uint64_t dataSize_ = 0;
+    std::string strings_;
+};
+
+/**
+ * A mapped cooked scene. open() fails, and the scene should be re-cooked,
+ * if the file is missing, of another version, cooked from a different
+ * source or out of date with a dependency, or if any table or blob lies
+ * outside the file or any index outside the vertices of its mesh.
+ */
+class CookedScene {
+public:
+    bool open(const std::filesystem::path &path, uint64_t sourceHash);
+
+    std::span<const CookedSampler> samplers() const { return table<CookedSampler>(header_->samplers); }
+    std::span<const CookedImage> images() const { return table<CookedImage>(header_->images); }
+    std::span<const CookedMaterial> materials() const { return table<CookedMaterial>(header_->materials); }
+    std::span<const CookedMesh> meshes() const { return table<CookedMesh>(header_->meshes); }
+    std::span<const CookedSurface> surfaces() const { return table<CookedSurface>(header_->surfaces); }
+    std::span<const CookedNode> nodes() const { return table<CookedNode>(header_->nodes); }
+
+    // Points into the mapping; valid while the scene is open
+    const void *data(const uint64_t offset) const { return file_.data() + header_->data.offset + offset; }
+    std::string_view string(const CookedString string) const { return {file_.data() + header_->strings.offset + string.offset, string.length}; }
+
+private:
+    MappedFile file_;
+    const CookedHeader *header_ = nullptr;
+
+    template<typename T>
+    std::span<const T> table(const CookedSection section) const {
+        return {reinterpret_cast<const T *>(file_.data() + section.offset), static_cast<size_t>(section.count)};
+    }
+
+    bool validate() const;
+};
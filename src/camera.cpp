@@ -1,4 +1,6 @@
 #include <camera.hpp>
+#include <fstream>
+#include <sstream>
 #include <glm/ext/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
@@ -42,4 +44,53 @@ void Camera::processSDLEvent(SDL_Event &event) {
 void Camera::update(float deltaTime) {
     const glm::mat4 rot = getRotationMatrix();
     position += glm::vec3(rot * glm::vec4(velocity * speed * deltaTime, 0.0f));
-}
\ No newline at end of file
+}
+
+std::optional<CameraPath> CameraPath::load(const std::filesystem::path &filePath) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    CameraPath path;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+
+        std::istringstream stream(line);
+        CameraKeyframe key;
+        if (stream >> key.frame >> key.position.x >> key.position.y >> key.position.z >> key.pitch >> key.yaw) {
+            path.keyframes.push_back(key);
+        }
+    }
+
+    if (path.keyframes.empty()) {
+        return {};
+    }
+    return path;
+}
+
+void CameraPath::apply(Camera &camera, const float frame) const {
+    camera.velocity = glm::vec3(0.0f);
+    if (keyframes.empty()) return;
+
+    // Find the segment [a, b] containing frame
+    size_t b = 0;
+    while (b < keyframes.size() && keyframes[b].frame < frame) {
+        ++b;
+    }
+    const CameraKeyframe &a = keyframes[b == 0 ? 0 : b - 1];
+    const CameraKeyframe &c = keyframes[b == keyframes.size() ? b - 1 : b];
+
+    float t = 0.0f;
+    if (c.frame > a.frame) {
+        t = glm::clamp((frame - a.frame) / (c.frame - a.frame), 0.0f, 1.0f);
+    }
+
+    camera.position = glm::mix(a.position, c.position, t);
+    camera.pitch    = glm::mix(a.pitch, c.pitch, t);
+    camera.yaw      = glm::mix(a.yaw, c.yaw, t);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SDL_events.h>
+#include <filesystem>
 #include <material.hpp>
 
 struct Camera {
@@ -16,4 +17,29 @@ struct Camera {
 
     void processSDLEvent(SDL_Event &event);
     void update(float deltaTime = 0.0f);
-};
\ No newline at end of file
+};
+
+/**
+ * A single camera pose on a scripted path, placed at a frame index
+ */
+struct CameraKeyframe {
+    float frame;
+    glm::vec3 position;
+    float pitch;
+    float yaw;
+};
+
+/**
+ * A keyframed camera path, linearly interpolated between keyframes.
+ *
+ * Text format, one keyframe per line (sorted by frame, '#' starts a comment):
+ *   frame x y z pitch yaw
+ */
+struct CameraPath {
+    std::vector<CameraKeyframe> keyframes;
+
+    static std::optional<CameraPath> load(const std::filesystem::path &filePath);
+
+    // Sets camera position, pitch & yaw for the given frame; clamps outside the keyframe range
+    void apply(Camera &camera, float frame) const;
+};
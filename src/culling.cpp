@@ -0,0 +1,146 @@
+#include <culling.hpp>
+#include <mesh.hpp>
+
+#include <bit>
+#include <cfloat>
+
+#include <glm/geometric.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+Frustum Frustum::fromViewProj(const glm::mat4 &viewProj) {
+    // Gribb-Hartmann: planes are sums/differences of the matrix rows (GLM is column-major)
+    const glm::vec4 row0{viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]};
+    const glm::vec4 row1{viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]};
+    const glm::vec4 row2{viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]};
+    const glm::vec4 row3{viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]};
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;// Left
+    frustum.planes[1] = row3 - row0;// Right
+    frustum.planes[2] = row3 + row1;// Bottom
+    frustum.planes[3] = row3 - row1;// Top
+    frustum.planes[4] = row3 + row2;// Near (-w <= z; conservative for [0, 1] depth as well)
+    frustum.planes[5] = row3 - row2;// Far
+
+    for (glm::vec4 &plane: frustum.planes) {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane /= length;
+    }
+
+    return frustum;
+}
+
+void CullingSpheres::resize(const uint32_t newCount) {
+    count = newCount;
+
+    const uint32_t padded = (newCount + JVK_CULL_BATCH - 1) / JVK_CULL_BATCH * JVK_CULL_BATCH;
+    centerX.assign(padded, 0.0f);
+    centerY.assign(padded, 0.0f);
+    centerZ.assign(padded, 0.0f);
+    radius.assign(padded, -FLT_MAX);
+}
+
+void CullingSpheres::set(const uint32_t index, const glm::mat4 &transform, const Bounds &bounds) {
+    const glm::vec4 center = transform * glm::vec4(bounds.origin, 1.0f);
+
+    // Non-uniform scale: the largest axis scale bounds the transformed sphere
+    const float sx    = glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0]));
+    const float sy    = glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]));
+    const float sz    = glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]));
+    const float scale = std::sqrt(std::max(sx, std::max(sy, sz)));
+
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    radius[index]  = bounds.sphereRadius * scale;
+}
+
+uint32_t cullSpheres(const Frustum &frustum, const CullingSpheres &spheres, uint32_t *visible) {
+    uint32_t visibleCount = 0;
+    const uint32_t padded = static_cast<uint32_t>(spheres.radius.size());
+
+    const float *cx = spheres.centerX.data();
+    const float *cy = spheres.centerY.data();
+    const float *cz = spheres.centerZ.data();
+    const float *r  = spheres.radius.data();
+
+#if defined(__AVX__)
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p) {
+        px[p] = _mm256_set1_ps(frustum.planes[p].x);
+        py[p] = _mm256_set1_ps(frustum.planes[p].y);
+        pz[p] = _mm256_set1_ps(frustum.planes[p].z);
+        pw[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+
+    for (uint32_t i = 0; i < padded; i += 8) {
+        const __m256 x    = _mm256_loadu_ps(cx + i);
+        const __m256 y    = _mm256_loadu_ps(cy + i);
+        const __m256 z    = _mm256_loadu_ps(cz + i);
+        const __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(r + i));
+
+        // Inside all planes: dot(plane, center) + w >= -radius
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(px[p], x), pw[p]);
+            d        = _mm256_add_ps(_mm256_mul_ps(py[p], y), d);
+            d        = _mm256_add_ps(_mm256_mul_ps(pz[p], z), d);
+            inside   = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+        }
+
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        while (mask) {
+            visible[visibleCount++] = i + std::countr_zero(mask);
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p) {
+        px[p] = _mm_set1_ps(frustum.planes[p].x);
+        py[p] = _mm_set1_ps(frustum.planes[p].y);
+        pz[p] = _mm_set1_ps(frustum.planes[p].z);
+        pw[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+
+    for (uint32_t i = 0; i < padded; i += 4) {
+        const __m128 x    = _mm_loadu_ps(cx + i);
+        const __m128 y    = _mm_loadu_ps(cy + i);
+        const __m128 z    = _mm_loadu_ps(cz + i);
+        const __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(r + i));
+
+        // Inside all planes: dot(plane, center) + w >= -radius
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(px[p], x), pw[p]);
+            d        = _mm_add_ps(_mm_mul_ps(py[p], y), d);
+            d        = _mm_add_ps(_mm_mul_ps(pz[p], z), d);
+            inside   = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+        while (mask) {
+            visible[visibleCount++] = i + std::countr_zero(mask);
+            mask &= mask - 1;
+        }
+    }
+#else
+    for (uint32_t i = 0; i < padded; ++i) {
+        bool inside = true;
+        for (const glm::vec4 &plane: frustum.planes) {
+            const float d = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+            inside &= d >= -r[i];
+        }
+        if (inside) {
+            visible[visibleCount++] = i;
+        }
+    }
+#endif
+
+    return visibleCount;
+}
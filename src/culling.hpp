@@ -0,0 +1,46 @@
+#pragma once
+
+#include <jvk.hpp>
+
+struct Bounds;
+
+// Number of spheres tested per SIMD iteration; SoA arrays are padded to a multiple of this
+constexpr uint32_t JVK_CULL_BATCH = 8;
+
+/**
+ * The six clip planes of a view-projection matrix, normalized so that
+ * dot(plane.xyz, p) + plane.w is the signed distance of p to the plane.
+ */
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromViewProj(const glm::mat4 &viewProj);
+};
+
+/**
+ * World-space bounding spheres in SoA layout for batched culling.
+ *
+ * Padding lanes have a radius of -FLT_MAX so they are never visible.
+ */
+struct CullingSpheres {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    uint32_t count = 0;
+
+    void resize(uint32_t newCount);
+
+    // Transforms a local-space bounding sphere into world space
+    void set(uint32_t index, const glm::mat4 &transform, const Bounds &bounds);
+};
+
+/**
+ * Tests every sphere against the frustum and writes the indices of the
+ * visible ones, in increasing order, to visible (which must hold at least
+ * spheres.count entries). Uses AVX when compiled with it, SSE otherwise,
+ * with a scalar fallback for other architectures.
+ *
+ * @return The number of visible spheres
+ */
+uint32_t cullSpheres(const Frustum &frustum, const CullingSpheres &spheres, uint32_t *visible);
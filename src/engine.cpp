@@ -23,6 +23,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 constexpr bool JVK_USE_VALIDATION_LAYERS = true;
 
@@ -37,26 +38,37 @@ void JVKEngine::init() {
     assert(loadedEngine == nullptr);
     loadedEngine = this;
 
-    SDL_Init(SDL_INIT_VIDEO);
+    if (!headless_) {
+        SDL_Init(SDL_INIT_VIDEO);
 
-    SDL_WindowFlags windowFlags = static_cast<SDL_WindowFlags>(SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
+        SDL_WindowFlags windowFlags = static_cast<SDL_WindowFlags>(SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
 
-    window_ = SDL_CreateWindow(
-            "JVK",
-            SDL_WINDOWPOS_UNDEFINED,
-            SDL_WINDOWPOS_UNDEFINED,
-            windowExtent_.width,
-            windowExtent_.height,
-            windowFlags);
+        window_ = SDL_CreateWindow(
+                "JVK",
+                SDL_WINDOWPOS_UNDEFINED,
+                SDL_WINDOWPOS_UNDEFINED,
+                windowExtent_.width,
+                windowExtent_.height,
+                windowFlags);
+    }
+
+    // JOBS
+    // The main thread is a worker too, so spawn one thread less
+    jobs_.init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
 
     initVulkan();
-    initSwapchain();
+    if (!headless_) {
+        initSwapchain();
+    }
     initDrawImages();
     initCommands();
     initSyncStructures();
+    initTimestampQueries();
     initDescriptors();
     initPipelines();
-    initImgui();
+    if (!headless_) {
+        initImgui();
+    }
     initDefaultData();
 
     // CAMERA
@@ -66,10 +78,9 @@ void JVKEngine::init() {
     mainCamera_.yaw      = 0.0f;
 
     // SCENE
-    std::string scenePath = "../assets/sponza.glb";
-    auto sceneFile        = loadGLTF(this, scenePath);
+    auto sceneFile = loadGLTF(this, scenePath_);
     assert(sceneFile.has_value());
-    loadedScenes_["base_scene"] = *sceneFile;
+    addScene("base_scene", *sceneFile);
 
     isInitialized_ = true;
     fmt::print("Engine initialized\n");
@@ -80,19 +91,34 @@ void JVKEngine::cleanup() {
         vkDeviceWaitIdle(ctx_.device);
 
         loadedScenes_.clear();
+        for (auto &[value, destroy]: deletionQueue_) {
+            destroy();
+        }
+        deletionQueue_.clear();
+        geometryArena_.destroy(this);
+
+        jobs_.destroy();
 
         // Frame data
-        for (int i = 0; i < JVK_NUM_FRAMES; ++i) {
+        for (int i = 0; i < JVK_MAX_FRAMES; ++i) {
             frames_[i].cmdPool.destroy();
+            for (uint32_t t = 0; t < recordThreadCount_; ++t) {
+                frames_[i].recordPools[t].destroy();
+            }
 
             // Frame sync
-            frames_[i].renderFence.destroy();
             frames_[i].renderSemaphore.destroy();
             frames_[i].swapchainSemaphore.destroy();
 
             frames_[i].sceneDataBuffer.destroy(allocator_);
 
             frames_[i].descriptorAllocator.destroyPools(ctx_.device);
+
+            if (gpuTimestampsSupported_) {
+                frames_[i].timestampPool.destroy();
+            }
+
+            releaseFrameBuffers(frames_[i]);
         }
 
         // Textures
@@ -105,17 +131,23 @@ void JVKEngine::cleanup() {
 
         // Default data
         metallicRoughnessMaterial_.clearResources(ctx_.device);
-        matConstants_.destroy(allocator_);
+        bindless_.destroy(this);
 
         // ImGui
-        ImGui_ImplVulkan_Shutdown();
-        vkDestroyDescriptorPool(ctx_.device, imguiPool_, nullptr);
+        if (!headless_) {
+            ImGui_ImplVulkan_Shutdown();
+            vkDestroyDescriptorPool(ctx_.device, imguiPool_, nullptr);
+        }
 
         // Immediate command pool
         immBuffer_.destroy();
+        graphicsTimeline_.destroy();
+        uploads_.destroy();
 
         // PIPELINES
         vkDestroyPipelineLayout(ctx_.device, computePipelineLayout_, nullptr);
+        vkDestroyPipelineLayout(ctx_.device, cullPipelineLayout_, nullptr);
+        vkDestroyPipeline(ctx_.device, cullPipeline_, nullptr);
         vkDestroyPipeline(ctx_.device, computeEffects_[0].pipeline, nullptr);
         vkDestroyPipeline(ctx_.device, computeEffects_[1].pipeline, nullptr);
 
@@ -135,42 +167,75 @@ void JVKEngine::cleanup() {
         vmaDestroyAllocator(allocator_);
 
         // Swapchain
-        swapchain_.destroy(ctx_);
+        if (!headless_) {
+            swapchain_.destroy(ctx_);
+        }
 
         // API
         ctx_.destroy();
-        SDL_DestroyWindow(window_);
+        if (!headless_) {
+            SDL_DestroyWindow(window_);
+        }
     }
 
     loadedEngine = nullptr;
 }
 
 void JVKEngine::draw() {
+    latency_.markSimulationStart();
     updateScene();
-    // Wait and reset render fence
-    VK_CHECK(getCurrentFrame().renderFence.wait());
+    // Wait for the previous use of this frame
+    auto fenceStart = std::chrono::steady_clock::now();
+    VK_CHECK(graphicsTimeline_.wait(getCurrentFrame().timelineValue));
+    auto fenceEnd        = std::chrono::steady_clock::now();
+    stats_.fenceWaitTime = std::chrono::duration_cast<std::chrono::microseconds>(fenceEnd - fenceStart).count() / 1000.0f;
+    pollPresentation();
+    collectGarbage();
     getCurrentFrame().descriptorAllocator.clearPools(ctx_.device);
-
-    VK_CHECK(getCurrentFrame().renderFence.reset());
+    for (uint32_t t = 0; t < recordThreadCount_; ++t) {
+        VK_CHECK(getCurrentFrame().recordPools[t].reset());
+    }
+    readTimestamps();
+    readIndirectCounts();
+    prepareTransforms();
+    if (gpuDrivenRendering_) {
+        prepareIndirectBuffers();
+    }
 
     // Request an image from swapchain
-    uint32_t swapchainImageIndex;
-    VkResult e = swapchain_.acquireNextImage(ctx_, getCurrentFrame().swapchainSemaphore, &swapchainImageIndex);
-    if (e == VK_ERROR_OUT_OF_DATE_KHR) {
-        resizeRequested_ = true;
-        return;
+    uint32_t swapchainImageIndex = 0;
+    if (!headless_) {
+        VkResult e = swapchain_.acquireNextImage(ctx_, getCurrentFrame().swapchainSemaphore, &swapchainImageIndex);
+        if (e == VK_ERROR_OUT_OF_DATE_KHR) {
+            resizeRequested_ = true;
+            return;
+        }
     }
 
     // Reset the command buffer
     auto cmd = getCurrentFrame().cmdBuffer;
     VK_CHECK(cmd.reset());
 
-    drawExtent_.width  = std::min(swapchain_.extent.width, drawImage_.imageExtent.width) * renderScale_;
-    drawExtent_.height = std::min(swapchain_.extent.height, drawImage_.imageExtent.height) * renderScale_;
+    if (headless_) {
+        drawExtent_.width  = drawImage_.imageExtent.width * renderScale_;
+        drawExtent_.height = drawImage_.imageExtent.height * renderScale_;
+    } else {
+        drawExtent_.width  = std::min(swapchain_.extent.width, drawImage_.imageExtent.width) * renderScale_;
+        drawExtent_.height = std::min(swapchain_.extent.height, drawImage_.imageExtent.height) * renderScale_;
+    }
 
     // Start the command buffer
     VK_CHECK(cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
 
+    // Submit pending uploads; acquire them (& generate mipmaps) when they ran on another queue family
+    uploads_.flush();
+    uploads_.recordGraphicsWork(cmd);
+
+    if (gpuTimestampsSupported_) {
+        getCurrentFrame().timestampPool.reset(cmd);
+        getCurrentFrame().timestampsRecorded = true;
+    }
+
     // Transition draw image to general
     jvk::transitionImage(cmd, drawImage_.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
 
@@ -184,28 +249,63 @@ void JVKEngine::draw() {
     vkCmdPushConstants(cmd, computePipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ComputePushConstants), &effect.data);
 
     // Draw compute
+    writeTimestamp(cmd, GPU_PASS_BACKGROUND, false);
     vkCmdDispatch(cmd, std::ceil(drawExtent_.width / 16.0f), std::ceil(drawExtent_.height / 16.0f), 1);
+    writeTimestamp(cmd, GPU_PASS_BACKGROUND, true);
+
+    // GPU-driven culling: fills the indirect commands consumed in drawGeometry
+    if (gpuDrivenRendering_) {
+        writeTimestamp(cmd, GPU_PASS_CULL, false);
+        dispatchCulling(cmd);
+        writeTimestamp(cmd, GPU_PASS_CULL, true);
+    }
 
     // Transition draw/depth images for render pass
     jvk::transitionImage(cmd, drawImage_.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     jvk::transitionImage(cmd, depthImage_.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
 
+    writeTimestamp(cmd, GPU_PASS_GEOMETRY, false);
     drawGeometry(cmd);
+    writeTimestamp(cmd, GPU_PASS_GEOMETRY, true);
 
     // Transition draw image to transfer source
     jvk::transitionImage(cmd, drawImage_.image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
+    // Headless: the draw image stays in transfer source for readback, nothing to present
+    if (headless_) {
+        VK_CHECK(cmd.end());
+
+        // Waits on uploads & signals the frame's timeline value, like the presenting path below
+        auto submitStart                  = std::chrono::steady_clock::now();
+        getCurrentFrame().timelineValue   = graphicsTimeline_.nextValue();
+        VkCommandBufferSubmitInfo cmdInfo = cmd.submitInfo();
+        VkSemaphoreSubmitInfo uploadInfo  = uploads_.timeline().submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, uploads_.submittedValue());
+        VkSemaphoreSubmitInfo signalInfo  = graphicsTimeline_.submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, getCurrentFrame().timelineValue);
+        VK_CHECK(graphicsQueue_.submit(&cmdInfo, {&uploadInfo, 1}, {&signalInfo, 1}));
+        latency_.markSubmit(0, getCurrentFrame().timelineValue);
+        auto submitEnd     = std::chrono::steady_clock::now();
+        stats_.submitTime  = std::chrono::duration_cast<std::chrono::microseconds>(submitEnd - submitStart).count() / 1000.0f;
+        stats_.presentTime = 0.0f;
+
+        frameNumber_++;
+        return;
+    }
+
     // Transition swapchain image to transfer destination
     jvk::transitionImage(cmd, swapchain_.images[swapchainImageIndex], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
     // Copy image to from draw image to swapchain
+    writeTimestamp(cmd, GPU_PASS_BLIT, false);
     jvk::copyImageToImage(cmd, drawImage_.image, swapchain_.images[swapchainImageIndex], drawExtent_, swapchain_.extent);
+    writeTimestamp(cmd, GPU_PASS_BLIT, true);
 
     // Transition swapchain to attachment optimal
     jvk::transitionImage(cmd, swapchain_.images[swapchainImageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
     // Draw UI
+    writeTimestamp(cmd, GPU_PASS_IMGUI, false);
     drawImgui(cmd, swapchain_.imageViews[swapchainImageIndex]);
+    writeTimestamp(cmd, GPU_PASS_IMGUI, true);
 
     // Transition swapchain for presentation
     jvk::transitionImage(cmd, swapchain_.images[swapchainImageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
@@ -216,10 +316,24 @@ void JVKEngine::draw() {
     // Submit buffer
     // srcStageMask set to COLOR_ATTACHMENT_OUTPUT_BIT to wait for color attachment output (waiting for swapchain image)
     // dstStageMask set to ALL_GRAPHICS_BIT to signal that all graphics stages are done
+    // The binary render semaphore is for presentation; the timeline value marks the frame as finished.
+    // Uploads (and their release to the graphics family) must land before the frame reads them.
+    auto submitStart                  = std::chrono::steady_clock::now();
+    getCurrentFrame().timelineValue   = graphicsTimeline_.nextValue();
     VkCommandBufferSubmitInfo cmdInfo = cmd.submitInfo();
-    VkSemaphoreSubmitInfo waitInfo    = getCurrentFrame().swapchainSemaphore.submitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
-    VkSemaphoreSubmitInfo signalInfo  = getCurrentFrame().renderSemaphore.submitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT);
-    graphicsQueue_.submit(&cmdInfo, &waitInfo, &signalInfo, getCurrentFrame().renderFence);
+    const VkSemaphoreSubmitInfo waitInfos[] = {
+            getCurrentFrame().swapchainSemaphore.submitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT),
+            uploads_.timeline().submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, uploads_.submittedValue()),
+    };
+    const VkSemaphoreSubmitInfo signalInfos[] = {
+            getCurrentFrame().renderSemaphore.submitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT),
+            graphicsTimeline_.submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, getCurrentFrame().timelineValue),
+    };
+    VK_CHECK(graphicsQueue_.submit(&cmdInfo, waitInfos, signalInfos));
+    const uint64_t presentId = ++presentId_;
+    latency_.markSubmit(presentId, getCurrentFrame().timelineValue);
+    auto submitEnd    = std::chrono::steady_clock::now();
+    stats_.submitTime = std::chrono::duration_cast<std::chrono::microseconds>(submitEnd - submitStart).count() / 1000.0f;
 
     // Present
     VkPresentInfoKHR presentInfo   = {};
@@ -231,112 +345,292 @@ void JVKEngine::draw() {
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pImageIndices      = &swapchainImageIndex;
 
+    VkPresentIdKHR presentIdInfo{};
+    presentIdInfo.sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds    = &presentId;
+    if (presentWaitSupported_) {
+        presentInfo.pNext = &presentIdInfo;
+    }
+
 
+    auto presentStart      = std::chrono::steady_clock::now();
     VkResult presentResult = vkQueuePresentKHR(graphicsQueue_, &presentInfo);
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR) {
         resizeRequested_ = true;
     }
+    auto presentEnd    = std::chrono::steady_clock::now();
+    stats_.presentTime = std::chrono::duration_cast<std::chrono::microseconds>(presentEnd - presentStart).count() / 1000.0f;
 
+    pollPresentation();
     frameNumber_++;
 }
 
 void JVKEngine::run() {
+    while (processEvents()) {
+        if (stopRendering_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        frame();
+    }
+}
+
+bool JVKEngine::processEvents() {
     SDL_Event e;
     bool bQuit = false;
 
-    while (!bQuit) {
-        auto start = std::chrono::system_clock::now();
+    while (SDL_PollEvent(&e) != 0) {
+        if (e.type == SDL_QUIT) bQuit = true;
 
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) bQuit = true;
+        // SDL stamps events in ms since init; convert to how long ago they were received
+        if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP || e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN || e.type == SDL_MOUSEBUTTONUP || e.type == SDL_MOUSEWHEEL) {
+            const auto age = std::chrono::milliseconds(SDL_GetTicks() - e.common.timestamp);
+            latency_.markInput(LatencyClock::now() - age);
+        }
 
-            if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT && !ImGui::GetIO().WantCaptureMouse) {
-                SDL_SetRelativeMouseMode(SDL_TRUE);
-            }
+        if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT && !ImGui::GetIO().WantCaptureMouse) {
+            SDL_SetRelativeMouseMode(SDL_TRUE);
+        }
 
-            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) {
-                SDL_SetRelativeMouseMode(SDL_FALSE);
-            }
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) {
+            SDL_SetRelativeMouseMode(SDL_FALSE);
+        }
 
-            if (e.type == SDL_WINDOWEVENT) {
-                if (e.window.event == SDL_WINDOWEVENT_MINIMIZED) {
-                    stopRendering_ = true;
-                }
-                if (e.window.event == SDL_WINDOWEVENT_RESTORED) {
-                    stopRendering_ = false;
-                }
+        if (e.type == SDL_WINDOWEVENT) {
+            if (e.window.event == SDL_WINDOWEVENT_MINIMIZED) {
+                stopRendering_ = true;
             }
-
-            if (SDL_GetRelativeMouseMode() == SDL_TRUE && !ImGui::GetIO().WantCaptureMouse) {
-                mainCamera_.processSDLEvent(e);
+            if (e.window.event == SDL_WINDOWEVENT_RESTORED) {
+                stopRendering_ = false;
             }
-            ImGui_ImplSDL2_ProcessEvent(&e);
         }
 
-        if (stopRendering_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
+        if (SDL_GetRelativeMouseMode() == SDL_TRUE && !ImGui::GetIO().WantCaptureMouse) {
+            mainCamera_.processSDLEvent(e);
         }
+        ImGui_ImplSDL2_ProcessEvent(&e);
+    }
+
+    return !bQuit;
+}
+
+void JVKEngine::frame() {
+    auto start = std::chrono::steady_clock::now();
+
+    pollPresentation();
+
+    if (pacingRequested_) {
+        setFramePacing(requestedPacing_);
+    }
 
+    if (!headless_) {
         if (resizeRequested_) {
             resizeSwapchain();
         }
 
-        ImGui_ImplVulkan_NewFrame();
-        ImGui_ImplSDL2_NewFrame();
+        drawUI();
+    }
+
+    draw();
+
+    auto end         = std::chrono::steady_clock::now();
+    auto elapsed     = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    stats_.frameTime = elapsed.count() / 1000.0f;
+    deltaTime_       = stats_.frameTime / 1000.0f;
+
+    // OVERLAP
+    // Fully serial frames take cpu + gpu, fully overlapped ones max(cpu, gpu)
+    const float cpuTime  = stats_.frameTime - stats_.fenceWaitTime - stats_.presentTime;
+    const float shorter  = std::min(cpuTime, stats_.gpuFrameTime);
+    stats_.cpuGpuOverlap = shorter > 0.0f ? std::clamp((cpuTime + stats_.gpuFrameTime - stats_.frameTime) / shorter, 0.0f, 1.0f) : 0.0f;
+
+    jobs_.collectStats(stats_.workers);
+    uploads_.collectStats(stats_.uploads);
+}
 
-        ImGui::NewFrame();
+void JVKEngine::drawUI() {
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplSDL2_NewFrame();
 
-        ImGui::Begin("Control Panel");
+    ImGui::NewFrame();
 
-        if (ImGui::BeginTabBar("MainTabs"))
+    ImGui::Begin("Control Panel");
+
+    if (ImGui::BeginTabBar("MainTabs"))
+    {
+        if (ImGui::BeginTabItem("Stats"))
         {
-            if (ImGui::BeginTabItem("Stats"))
-            {
-                ImGui::Text("Frame time %f ms", stats_.frameTime);
-                ImGui::Text("Draw time %f ms", stats_.meshDrawTime);
-                ImGui::Text("Update time %f ms", stats_.sceneUpdateTime);
-                ImGui::Text("Triangles %i", stats_.triangleCount);
-                ImGui::Text("Draws %i", stats_.drawCallCount);
-                ImGui::EndTabItem();
+            ImGui::Text("Frame time %f ms", stats_.frameTime);
+            ImGui::Text("Draw time %f ms", stats_.meshDrawTime);
+            ImGui::Text("Update time %f ms", stats_.sceneUpdateTime);
+            ImGui::Text("Submit time %f ms", stats_.submitTime);
+            ImGui::Text("Present time %f ms", stats_.presentTime);
+            ImGui::Text("Fence wait %f ms", stats_.fenceWaitTime);
+            ImGui::Text("GPU frame %f ms", stats_.gpuFrameTime);
+            ImGui::Text("CPU/GPU overlap %.0f%%", stats_.cpuGpuOverlap * 100.0f);
+            ImGui::Text("Triangles %i", stats_.triangleCount);
+            ImGui::Text("Draws %i", stats_.drawCallCount);
+            ImGui::Text("Visible %i / culled %i", stats_.visibleCount, stats_.culledCount);
+            ImGui::Text("Recording threads %i", stats_.recordThreadCount);
+            ImGui::Text("Arena vertices %u / %u", geometryArena_.vertices.used(), geometryArena_.vertices.capacity());
+            ImGui::Text("Arena indices %u / %u", geometryArena_.indices.used(), geometryArena_.indices.capacity());
+            ImGui::Text("Uploads %u batches, %.2f MB (%s transfer queue)", stats_.uploads.batchCount, stats_.uploads.byteCount / (1024.0f * 1024.0f), uploads_.dedicatedQueue() ? "dedicated" : "graphics");
+
+            // Sorted on demand, only while the tab is shown
+            LatencyPercentiles inputLatency, simulationLatency, submitLatency;
+            latency_.percentiles(inputLatency, simulationLatency, submitLatency);
+
+            ImGui::SeparatorText(presentWaitSupported_ ? "Latency (present wait)" : "Latency (GPU completion)");
+            const auto latencyRow = [](const char *name, const LatencyPercentiles &l) {
+                ImGui::Text("%s p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", name, l.p50, l.p95, l.p99, l.max);
+            };
+            latencyRow("Input", inputLatency);
+            latencyRow("Simulation", simulationLatency);
+            latencyRow("Submit", submitLatency);
+
+            ImGui::SeparatorText("Workers");
+            for (uint32_t i = 0; i < stats_.workers.size(); ++i) {
+                const JobSystem::WorkerStats &worker = stats_.workers[i];
+                const float utilization              = stats_.frameTime > 0.0f ? 100.0f * worker.busyTime / stats_.frameTime : 0.0f;
+                ImGui::Text("%u: %.2f ms (%.0f%%), %u jobs, %u stolen", i, worker.busyTime, utilization, worker.jobCount, worker.stealCount);
             }
 
-            if (ImGui::BeginTabItem("Camera"))
-            {
-                ImGui::SliderFloat("Speed", &mainCamera_.speed, 0.0f, 1000.0f);
-                ImGui::EndTabItem();
+            if (gpuTimestampsSupported_) {
+                ImGui::SeparatorText("GPU");
+                for (uint32_t i = 0; i < GPU_PASS_COUNT; ++i) {
+                    ImGui::Text("%s %f ms", GPU_PASS_NAMES[i], stats_.gpuPassTimes[i]);
+                }
+            } else {
+                ImGui::Text("GPU timestamps unsupported");
             }
+            ImGui::EndTabItem();
+        }
 
-            if (ImGui::BeginTabItem("Compute Effects"))
-            {
-                ImGui::SliderFloat("Render Scale", &renderScale_, 0.3f, 1.0f);
+        if (ImGui::BeginTabItem("Camera"))
+        {
+            ImGui::Checkbox("Frustum culling", &frustumCulling_);
+            ImGui::Checkbox("Parallel recording", &parallelRecording_);
+            ImGui::Checkbox("Instancing", &instancing_);
+            ImGui::Checkbox("GPU-driven", &gpuDrivenRendering_);
+
+            int sortMode = static_cast<int>(drawSortMode_);
+            ImGui::Combo("Draw order", &sortMode, "State\0Front to back\0");
+            drawSortMode_ = static_cast<DrawSortMode>(sortMode);
+            ImGui::SliderFloat("Speed", &mainCamera_.speed, 0.0f, 1000.0f);
+            ImGui::EndTabItem();
+        }
 
-                ComputeEffect &selected = computeEffects_[currentComputeEffect_];
+        if (ImGui::BeginTabItem("Pacing"))
+        {
+            static constexpr VkPresentModeKHR presentModes[] = {VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR};
+
+            FramePacing pacing = {frameCount_, presentMode_};
+            int frameCount     = static_cast<int>(frameCount_);
+            if (ImGui::SliderInt("Frames in flight", &frameCount, 1, JVK_MAX_FRAMES)) {
+                pacing.frameCount = static_cast<uint32_t>(frameCount);
+                pacingRequested_  = true;
+            }
 
-                ImGui::Text("Selected effect: %s", selected.name); // Changed to %s for string
-                ImGui::SliderInt("Effect Index", &currentComputeEffect_, 0, computeEffects_.size() - 1);
+            int mode = static_cast<int>(std::find(std::begin(presentModes), std::end(presentModes), presentMode_) - std::begin(presentModes));
+            if (ImGui::Combo("Present mode", &mode, "FIFO\0FIFO relaxed\0Mailbox\0Immediate\0")) {
+                pacing.presentMode = presentModes[mode];
+                pacingRequested_   = true;
+            }
+            if (!headless_ && swapchain_.presentMode != presentMode_) {
+                ImGui::Text("Unsupported, using %s", string_VkPresentModeKHR(swapchain_.presentMode));
+            }
 
-                ImGui::InputFloat4("Input 1", reinterpret_cast<float *>(&selected.data.data1));
-                ImGui::InputFloat4("Input 2", reinterpret_cast<float *>(&selected.data.data2));
-                ImGui::InputFloat4("Input 3", reinterpret_cast<float *>(&selected.data.data3));
-                ImGui::InputFloat4("Input 4", reinterpret_cast<float *>(&selected.data.data4));
-                ImGui::EndTabItem();
+            if (ImGui::Button("Low latency")) {
+                pacing           = JVK_PACING_LOW_LATENCY;
+                pacingRequested_ = true;
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Default")) {
+                pacing           = JVK_PACING_DEFAULT;
+                pacingRequested_ = true;
             }
+            ImGui::SameLine();
+            if (ImGui::Button("Max throughput")) {
+                pacing           = JVK_PACING_MAX_THROUGHPUT;
+                pacingRequested_ = true;
+            }
+            requestedPacing_ = pacing;
 
-            ImGui::EndTabBar();
+            ImGui::Text("CPU/GPU overlap %.0f%%", stats_.cpuGpuOverlap * 100.0f);
+            LatencyPercentiles inputLatency, simulationLatency, submitLatency;
+            latency_.percentiles(inputLatency, simulationLatency, submitLatency);
+            ImGui::Text("Input to photon p50 %.2f  p99 %.2f ms", inputLatency.p50, inputLatency.p99);
+            ImGui::EndTabItem();
         }
 
-        ImGui::End();
+        if (ImGui::BeginTabItem("Compute Effects"))
+        {
+            ImGui::SliderFloat("Render Scale", &renderScale_, 0.3f, 1.0f);
+
+            ComputeEffect &selected = computeEffects_[currentComputeEffect_];
+
+            ImGui::Text("Selected effect: %s", selected.name); // Changed to %s for string
+            ImGui::SliderInt("Effect Index", &currentComputeEffect_, 0, computeEffects_.size() - 1);
+
+            ImGui::InputFloat4("Input 1", reinterpret_cast<float *>(&selected.data.data1));
+            ImGui::InputFloat4("Input 2", reinterpret_cast<float *>(&selected.data.data2));
+            ImGui::InputFloat4("Input 3", reinterpret_cast<float *>(&selected.data.data3));
+            ImGui::InputFloat4("Input 4", reinterpret_cast<float *>(&selected.data.data4));
+            ImGui::EndTabItem();
+        }
+
+        ImGui::EndTabBar();
+    }
+
+    ImGui::End();
+
+    ImGui::Render();
+}
+
+void JVKEngine::runHeadless(const uint32_t frameCount) {
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        frame();
+    }
+
+    VK_CHECK(vkDeviceWaitIdle(ctx_.device));
+}
+
+std::vector<uint8_t> JVKEngine::readbackDrawImage() {
+    // The draw image is left in TRANSFER_SRC_OPTIMAL at the end of every frame
+    VK_CHECK(vkDeviceWaitIdle(ctx_.device));
+
+    const size_t texelCount = static_cast<size_t>(drawExtent_.width) * drawExtent_.height;
+    jvk::Buffer readback    = createBuffer(texelCount * 4 * sizeof(uint16_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+    immBuffer_.submit(graphicsQueue_, [&](VkCommandBuffer cmd) {
+        VkBufferImageCopy copyRegion{};
+        copyRegion.bufferOffset      = 0;
+        copyRegion.bufferRowLength   = 0;
+        copyRegion.bufferImageHeight = 0;
+
+        copyRegion.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel       = 0;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount     = 1;
+        copyRegion.imageExtent                     = {drawExtent_.width, drawExtent_.height, 1};
 
-        ImGui::Render();
+        vkCmdCopyImageToBuffer(cmd, drawImage_.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.buffer, 1, &copyRegion);
+    });
 
-        draw();
+    VK_CHECK(vmaInvalidateAllocation(allocator_, readback.allocation, 0, VK_WHOLE_SIZE));
 
-        auto end         = std::chrono::system_clock::now();
-        auto elapsed     = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        stats_.frameTime = elapsed.count() / 1000.0f;
-        deltaTime_       = stats_.frameTime / 1000.0f;
+    // R16G16B16A16_SFLOAT -> R8G8B8A8_UNORM
+    const uint16_t *halfs = static_cast<const uint16_t *>(readback.info.pMappedData);
+    std::vector<uint8_t> pixels(texelCount * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        const float v = glm::clamp(glm::unpackHalf1x16(halfs[i]), 0.0f, 1.0f);
+        pixels[i]     = static_cast<uint8_t>(v * 255.0f + 0.5f);
     }
+
+    destroyBuffer(readback);
+    return pixels;
 }
 
 void JVKEngine::initVulkan() {
@@ -346,6 +640,7 @@ void JVKEngine::initVulkan() {
                                      .request_validation_layers(JVK_USE_VALIDATION_LAYERS)
                                      .use_default_debug_messenger()
                                      .require_api_version(1, 3, 0)
+                                     .set_headless(headless_)
                                      .build();
 
     if (!vkbInstanceResult) {
@@ -359,7 +654,11 @@ void JVKEngine::initVulkan() {
     ctx_.debugMessenger = vkbInstance.debug_messenger;
 
     // CREATE SURFACE
-    SDL_Vulkan_CreateSurface(window_, ctx_, &ctx_.surface);
+    if (headless_) {
+        ctx_.surface = VK_NULL_HANDLE;
+    } else {
+        SDL_Vulkan_CreateSurface(window_, ctx_, &ctx_.surface);
+    }
 
     // 1.3 FEATURES
     VkPhysicalDeviceVulkan13Features features13{};
@@ -371,14 +670,30 @@ void JVKEngine::initVulkan() {
     features12.sType               = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
     features12.bufferDeviceAddress = true;
     features12.descriptorIndexing  = true;
+    features12.drawIndirectCount   = true;
+    features12.timelineSemaphore   = true;
+
+    // Bindless textures & samplers (see BindlessTable)
+    features12.runtimeDescriptorArray                       = true;
+    features12.descriptorBindingPartiallyBound              = true;
+    features12.descriptorBindingSampledImageUpdateAfterBind = true;
+    features12.descriptorBindingUpdateUnusedWhilePending    = true;
+    features12.shaderSampledImageArrayNonUniformIndexing    = true;
+
+    // firstInstance carries the draw index in GPU-driven draws
+    VkPhysicalDeviceFeatures features{};
+    features.drawIndirectFirstInstance = true;
 
     // PHYSICAL DEVICE
     vkb::PhysicalDeviceSelector physicalDeviceBuilder{vkbInstance};
-    auto vkbPhysicalDeviceResult = physicalDeviceBuilder.set_minimum_version(1, 3)
-                                           .set_required_features_13(features13)
-                                           .set_required_features_12(features12)
-                                           .set_surface(ctx_)
-                                           .select();
+    physicalDeviceBuilder.set_minimum_version(1, 3)
+            .set_required_features_13(features13)
+            .set_required_features_12(features12)
+            .set_required_features(features);
+    if (!headless_) {
+        physicalDeviceBuilder.set_surface(ctx_);
+    }
+    auto vkbPhysicalDeviceResult = physicalDeviceBuilder.select();
 
     if (!vkbPhysicalDeviceResult) {
         fmt::println("Failed to select physical device. Error: {}", vkbPhysicalDeviceResult.error().message());
@@ -387,16 +702,67 @@ void JVKEngine::initVulkan() {
 
     vkb::PhysicalDevice vkbPhysicalDevice = vkbPhysicalDeviceResult.value();
 
+    // BLOCK COMPRESSION
+    // Optional: selected again with BCn required, which keeps the same device
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(vkbPhysicalDevice.physical_device, &supportedFeatures);
+    textureCompressionBCSupported_ = supportedFeatures.textureCompressionBC;
+    if (textureCompressionBCSupported_) {
+        features.textureCompressionBC = true;
+        vkbPhysicalDevice             = physicalDeviceBuilder.set_required_features(features).select().value();
+    }
+
+    // PRESENT WAIT
+    // Optional: exact presentation times for latency stats, fence completion otherwise
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    if (!headless_ && vkbPhysicalDevice.is_extension_present(VK_KHR_PRESENT_ID_EXTENSION_NAME) && vkbPhysicalDevice.is_extension_present(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        presentIdFeatures.pNext = &presentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2 supported{};
+        supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supported.pNext = &presentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(vkbPhysicalDevice.physical_device, &supported);
+
+        presentIdFeatures.pNext = nullptr;
+        presentWaitSupported_   = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+        if (presentWaitSupported_) {
+            vkbPhysicalDevice.enable_extension_if_present(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            vkbPhysicalDevice.enable_extension_if_present(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+    }
+
     // DEVICE
     vkb::DeviceBuilder deviceBuilder{vkbPhysicalDevice};
+    if (presentWaitSupported_) {
+        deviceBuilder.add_pNext(&presentIdFeatures).add_pNext(&presentWaitFeatures);
+    }
     vkb::Device vkbDevice   = deviceBuilder.build().value();
     ctx_.device         = vkbDevice.device;
     ctx_.physicalDevice = vkbPhysicalDevice.physical_device;
 
+    if (presentWaitSupported_) {
+        waitForPresent_ = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(ctx_.device, "vkWaitForPresentKHR"));
+    }
+
     // QUEUE
     graphicsQueue_.queue  = vkbDevice.get_queue(vkb::QueueType::graphics).value();
     graphicsQueue_.family = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
 
+    // Prefer a transfer-only family, then any family other than graphics
+    if (auto queue = vkbDevice.get_dedicated_queue(vkb::QueueType::transfer)) {
+        transferQueue_.queue  = queue.value();
+        transferQueue_.family = vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+    } else if (auto separate = vkbDevice.get_queue(vkb::QueueType::transfer)) {
+        transferQueue_.queue  = separate.value();
+        transferQueue_.family = vkbDevice.get_queue_index(vkb::QueueType::transfer).value();
+    } else {
+        transferQueue_ = graphicsQueue_;
+    }
+
     // VMA
     VmaAllocatorCreateInfo allocatorInfo = {};
     allocatorInfo.physicalDevice         = ctx_.physicalDevice;
@@ -410,7 +776,7 @@ void JVKEngine::initVulkan() {
 }
 
 void JVKEngine::initSwapchain() {
-    swapchain_.init(ctx_, windowExtent_.width, windowExtent_.height);
+    swapchain_.init(ctx_, windowExtent_.width, windowExtent_.height, VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR, presentMode_);
 }
 
 void JVKEngine::initCommands() {
@@ -418,24 +784,96 @@ void JVKEngine::initCommands() {
     // Indicate that buffers should be individually resettable
     VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
+    // RECORDING THREADS
+    recordThreadCount_ = std::min(jobs_.workerCount(), JVK_MAX_RECORD_THREADS);
+
     // COMMAND BUFFERS
-    for (int i = 0; i < JVK_NUM_FRAMES; ++i) {
+    for (int i = 0; i < JVK_MAX_FRAMES; ++i) {
         VK_CHECK(frames_[i].cmdPool.init(ctx_, graphicsQueue_.family, flags));
         VK_CHECK(frames_[i].cmdPool.allocateCommandBuffer(&frames_[i].cmdBuffer));
+
+        for (uint32_t t = 0; t < recordThreadCount_; ++t) {
+            VK_CHECK(frames_[i].recordPools[t].init(ctx_, graphicsQueue_.family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT));
+            VK_CHECK(frames_[i].recordPools[t].allocateCommandBuffer(&frames_[i].recordBuffers[t], 1, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+        }
     }
 
     // IMMEDIATE BUFFERS
-    VK_CHECK(immBuffer_.init(ctx_, graphicsQueue_.family, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+    VK_CHECK(graphicsTimeline_.init(ctx_));
+    VK_CHECK(immBuffer_.init(ctx_, graphicsQueue_.family, &graphicsTimeline_, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    // UPLOADS
+    uploads_.init(this, transferQueue_, graphicsQueue_.family);
 }
 
 void JVKEngine::initSyncStructures() {
-    for (int i = 0; i < JVK_NUM_FRAMES; ++i) {
-        VK_CHECK(frames_[i].renderFence.init(ctx_, VK_FENCE_CREATE_SIGNALED_BIT));
+    for (int i = 0; i < JVK_MAX_FRAMES; ++i) {
         VK_CHECK(frames_[i].swapchainSemaphore.init(ctx_));
         VK_CHECK(frames_[i].renderSemaphore.init(ctx_));
     }
 }
 
+void JVKEngine::initTimestampQueries() {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(ctx_, &props);
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx_, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx_, &familyCount, families.data());
+
+    const uint32_t validBits = families[graphicsQueue_.family].timestampValidBits;
+    gpuTimestampsSupported_  = validBits > 0 && props.limits.timestampPeriod > 0.0f;
+    if (!gpuTimestampsSupported_) {
+        fmt::println("GPU timestamps not supported on the graphics queue");
+        return;
+    }
+
+    timestampPeriod_ = props.limits.timestampPeriod;
+    timestampMask_   = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    for (int i = 0; i < JVK_MAX_FRAMES; ++i) {
+        VK_CHECK(frames_[i].timestampPool.init(ctx_, VK_QUERY_TYPE_TIMESTAMP, GPU_PASS_COUNT * 2));
+    }
+}
+
+void JVKEngine::writeTimestamp(VkCommandBuffer cmd, const GPUPass pass, const bool end) {
+    if (!gpuTimestampsSupported_) return;
+    getCurrentFrame().timestampPool.writeTimestamp(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, pass * 2 + (end ? 1 : 0));
+}
+
+void JVKEngine::readTimestamps() {
+    if (!gpuTimestampsSupported_ || !getCurrentFrame().timestampsRecorded) return;
+
+    // The frame's fence has been waited on, so this never blocks. Queries that were not
+    // written (first frames, passes skipped in headless) report as unavailable.
+    uint64_t results[GPU_PASS_COUNT * 2][2];
+    getCurrentFrame().timestampPool.getResults(&results[0][0]);
+
+    // Passes are written in order, so the frame spans the first to the last written one
+    const uint64_t *frameBegin = nullptr;
+    const uint64_t *frameEnd   = nullptr;
+    for (uint32_t i = 0; i < GPU_PASS_COUNT; ++i) {
+        const uint64_t *begin = results[i * 2];
+        const uint64_t *end   = results[i * 2 + 1];
+        if (begin[1] == 0 || end[1] == 0) {
+            stats_.gpuPassTimes[i] = 0.0f;
+            continue;
+        }
+
+        const uint64_t ticks   = (end[0] - begin[0]) & timestampMask_;
+        stats_.gpuPassTimes[i] = static_cast<float>(ticks * static_cast<double>(timestampPeriod_) / 1000000.0);
+
+        if (!frameBegin) frameBegin = begin;
+        frameEnd = end;
+    }
+
+    if (frameBegin) {
+        const uint64_t ticks = (frameEnd[0] - frameBegin[0]) & timestampMask_;
+        stats_.gpuFrameTime  = static_cast<float>(ticks * static_cast<double>(timestampPeriod_) / 1000000.0);
+    }
+}
+
 void JVKEngine::drawBackground(VkCommandBuffer cmd) const {
     VkClearColorValue clearValue;
     float flash = std::abs(std::sin(frameNumber_ / 120.0f));
@@ -482,7 +920,7 @@ void JVKEngine::initDescriptors() {
     }
 
     // FRAME DESCRIPTORS
-    for (int i = 0; i < JVK_NUM_FRAMES; ++i) {
+    for (int i = 0; i < JVK_MAX_FRAMES; ++i) {
         std::vector<jvk::DynamicDescriptorAllocator::PoolSizeRatio> frameSizes = {
                 {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 3},
                 {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3},
@@ -506,13 +944,47 @@ void JVKEngine::initDescriptors() {
         builder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
         singleImageDescriptorLayout_ = builder.build(ctx_.device, VK_SHADER_STAGE_FRAGMENT_BIT);
     }
+
+    // BINDLESS MATERIALS
+    bindless_.init(this);
 }
 
 void JVKEngine::initPipelines() {
     initBackgroundPipelines();
+    initCullPipeline();
     metallicRoughnessMaterial_.buildPipelines(this);
 }
 
+void JVKEngine::initCullPipeline() {
+    // PIPELINE LAYOUT
+    // No descriptors: every buffer is passed by device address
+    VkPushConstantRange pushConstant{};
+    pushConstant.offset     = 0;
+    pushConstant.size       = sizeof(CullPushConstants);
+    pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkPipelineLayoutCreateInfo layout{};
+    layout.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout.pNext                  = nullptr;
+    layout.pPushConstantRanges    = &pushConstant;
+    layout.pushConstantRangeCount = 1;
+    VK_CHECK(vkCreatePipelineLayout(ctx_.device, &layout, nullptr, &cullPipelineLayout_));
+
+    VkShaderModule cullShader;
+    if (!jvk::loadShaderModule("../shaders/cull.comp.spv", ctx_.device, &cullShader)) {
+        fmt::println("Error when building cull compute shader");
+    }
+
+    VkComputePipelineCreateInfo computeInfo{};
+    computeInfo.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    computeInfo.pNext  = nullptr;
+    computeInfo.layout = cullPipelineLayout_;
+    computeInfo.stage  = jvk::init::pipelineShaderStage(VK_SHADER_STAGE_COMPUTE_BIT, cullShader);
+    VK_CHECK(vkCreateComputePipelines(ctx_.device, VK_NULL_HANDLE, 1, &computeInfo, nullptr, &cullPipeline_));
+
+    vkDestroyShaderModule(ctx_.device, cullShader, nullptr);
+}
+
 void JVKEngine::initBackgroundPipelines() {
     // PIPELINE LAYOUT
     // Pass an aray of descriptor set layouts, push constants, etc
@@ -638,34 +1110,21 @@ void JVKEngine::drawImgui(VkCommandBuffer cmd, VkImageView targetImageView) cons
 }
 
 void JVKEngine::drawGeometry(VkCommandBuffer cmd) {
-    stats_.drawCallCount = 0;
-    stats_.triangleCount = 0;
-    auto start           = std::chrono::system_clock::now();
+    auto start = std::chrono::steady_clock::now();
 
     // SORT DRAWS
-    std::vector<uint32_t> opaqueDraws;
-    opaqueDraws.reserve(drawCtx_.opaqueSurfaces.size());
-    for (uint32_t i = 0; i < drawCtx_.opaqueSurfaces.size(); ++i) {
-        opaqueDraws.push_back(i);
+    // Only surfaces that survived culling; visibleDraws_ is ordered opaque first.
+    // Depth is the view-space z of the world-space bounding sphere center.
+    const glm::vec4 viewZ{sceneData_.view[0][2], sceneData_.view[1][2], sceneData_.view[2][2], sceneData_.view[3][2]};
+    for (uint32_t i = 0; i < visibleOpaqueCount_; ++i) {
+        const uint32_t index = visibleDraws_[i];
+        const float depth    = -(viewZ.x * opaqueSpheres_.centerX[index] + viewZ.y * opaqueSpheres_.centerY[index] + viewZ.z * opaqueSpheres_.centerZ[index] + viewZ.w);
+
+        sortKeys_[i]    = makeSortKey(drawSortMode_, drawCtx_.opaqueSurfaces[index].stateKey, quantizeDepth(depth));
+        sortedDraws_[i] = index;
     }
-
-    std::sort(opaqueDraws.begin(), opaqueDraws.end(), [&](const auto &iA, const auto &iB) {
-        const RenderObject &A = drawCtx_.opaqueSurfaces[iA];
-        const RenderObject &B = drawCtx_.opaqueSurfaces[iB];
-
-        if (A.material == B.material) {
-            return A.indexBuffer < B.indexBuffer;
-        }
-        return A.material < B.material;
-    });
-
-    // SETUP RENDER PASS
-    VkRenderingAttachmentInfo colorAttachment = jvk::init::renderingAttachment(drawImage_.imageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    VkRenderingAttachmentInfo depthAttachment = jvk::init::depthRenderingAttachment(depthImage_.imageView, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
-    VkRenderingInfo renderingInfo             = jvk::init::rendering(drawExtent_, &colorAttachment, &depthAttachment);
-
-    // BEGIN RENDER PASS
-    vkCmdBeginRendering(cmd, &renderingInfo);
+    radixSort(sortKeys_.data(), sortedDraws_.data(), sortKeysTmp_.data(), sortedDrawsTmp_.data(), visibleOpaqueCount_);
+    buildInstancedDraws();
 
     // UNIFORM BUFFERS & GLOBAL DESCRIPTOR SET
     // Contains global scene data (projection matrices, light, etc)
@@ -677,41 +1136,162 @@ void JVKEngine::drawGeometry(VkCommandBuffer cmd) {
     writer.writeBuffer(0, sceneDataBuffer.buffer, sizeof(GPUSceneData), 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
     writer.updateSet(ctx_.device, getCurrentFrame().sceneDataDescriptorSet);
 
-    MaterialPipeline *lastPipeline = nullptr;
-    MaterialInstance *lastMaterial = nullptr;
-    VkBuffer lastIndexBuffer       = VK_NULL_HANDLE;
-
-    auto draw = [&](const RenderObject &r) {
-        if (r.material != lastMaterial) {
-            lastMaterial = r.material;
-
-            // Rebind pipeline and global descriptors if material is different
-            if (r.material->pipeline != lastPipeline) {
-                lastPipeline = r.material->pipeline;
-
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r.material->pipeline->pipeline);
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r.material->pipeline->pipelineLayout, 0, 1, &getCurrentFrame().sceneDataDescriptorSet, 0, nullptr);
-
-                VkViewport viewport{};
-                viewport.x        = 0;
-                viewport.y        = 0;
-                viewport.width    = drawExtent_.width;
-                viewport.height   = drawExtent_.height;
-                viewport.minDepth = 0.0f;
-                viewport.maxDepth = 1.0f;
-                vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-                // SCISSOR
-                VkRect2D scissor{};
-                scissor.offset.x      = 0;
-                scissor.offset.y      = 0;
-                scissor.extent.width  = drawExtent_.width;
-                scissor.extent.height = drawExtent_.height;
-                vkCmdSetScissor(cmd, 0, 1, &scissor);
+    // SETUP RENDER PASS
+    VkRenderingAttachmentInfo colorAttachment = jvk::init::renderingAttachment(drawImage_.imageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    VkRenderingAttachmentInfo depthAttachment = jvk::init::depthRenderingAttachment(depthImage_.imageView, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+    VkRenderingInfo renderingInfo             = jvk::init::rendering(drawExtent_, &colorAttachment, &depthAttachment);
+
+    // SPLIT OPAQUE DRAWS
+    // One chunk per recording thread, each with at least JVK_MIN_DRAWS_PER_THREAD draws
+    uint32_t chunkCount = 1;
+    if (parallelRecording_ && !gpuDrivenRendering_) {
+        chunkCount = std::clamp(instancedOpaqueCount_ / JVK_MIN_DRAWS_PER_THREAD, 1u, recordThreadCount_);
+    }
+
+    int drawCounts[JVK_MAX_RECORD_THREADS]     = {};
+    int triangleCounts[JVK_MAX_RECORD_THREADS] = {};
+
+    if (chunkCount == 1) {
+        vkCmdBeginRendering(cmd, &renderingInfo);
+        if (gpuDrivenRendering_) {
+            recordIndirectDraws(cmd, drawCounts[0]);
+            triangleCounts[0] = static_cast<int>(gpuVisibleTriangles_);
+        }
+        recordDraws(cmd, 0, instancedOpaqueCount_, true, drawCounts[0], triangleCounts[0]);
+        vkCmdEndRendering(cmd);
+    } else {
+        // SECONDARY COMMAND BUFFERS
+        // Dynamic rendering state is inherited; viewport, scissor & bindings are not
+        const VkFormat colorFormat = drawImage_.imageFormat;
+
+        VkCommandBufferInheritanceRenderingInfo renderingInheritance{};
+        renderingInheritance.sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        renderingInheritance.colorAttachmentCount    = 1;
+        renderingInheritance.pColorAttachmentFormats = &colorFormat;
+        renderingInheritance.depthAttachmentFormat   = depthImage_.imageFormat;
+        renderingInheritance.rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT;
+
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.pNext = &renderingInheritance;
+
+        FrameData &frame = getCurrentFrame();
+        // One job per chunk; each chunk owns its command pool
+        jobs_.parallelFor(chunkCount, 1, [&](const uint32_t firstChunk, const uint32_t lastChunk) {
+            for (uint32_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                const uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(instancedOpaqueCount_) * chunk / chunkCount);
+                const uint32_t last  = static_cast<uint32_t>(static_cast<uint64_t>(instancedOpaqueCount_) * (chunk + 1) / chunkCount);
+
+                // Transparent draws go last, after every opaque chunk
+                const jvk::CommandBuffer &secondary = frame.recordBuffers[chunk];
+                VK_CHECK(secondary.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritance));
+                recordDraws(secondary, first, last, chunk == chunkCount - 1, drawCounts[chunk], triangleCounts[chunk]);
+                VK_CHECK(secondary.end());
+            }
+        });
+
+        VkCommandBuffer secondaries[JVK_MAX_RECORD_THREADS];
+        for (uint32_t i = 0; i < chunkCount; ++i) {
+            secondaries[i] = frame.recordBuffers[i];
+        }
+
+        renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        vkCmdBeginRendering(cmd, &renderingInfo);
+        vkCmdExecuteCommands(cmd, chunkCount, secondaries);
+        vkCmdEndRendering(cmd);
+    }
+
+    stats_.drawCallCount     = 0;
+    stats_.triangleCount     = 0;
+    stats_.recordThreadCount = static_cast<int>(chunkCount);
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        stats_.drawCallCount += drawCounts[i];
+        stats_.triangleCount += triangleCounts[i];
+    }
+
+    auto end            = std::chrono::steady_clock::now();
+    auto elapsed        = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    stats_.meshDrawTime = elapsed.count() / 1000.0f;
+}
+
+void JVKEngine::buildInstancedDraws() {
+    FrameData &frame = getCurrentFrame();
+    if (visibleCount_ == 0) {
+        instancedDrawCount_   = 0;
+        instancedOpaqueCount_ = 0;
+        return;
+    }
+
+    // This frame's fence has been waited on, so its instance buffer can be rewritten
+    uint32_t *instances = static_cast<uint32_t *>(frame.instanceBuffer.info.pMappedData);
+    uint32_t runCount   = 0;
+
+    for (uint32_t i = 0; i < visibleOpaqueCount_; ++i) {
+        const uint32_t index  = sortedDraws_[i];
+        const RenderObject &r = drawCtx_.opaqueSurfaces[index];
+        instances[i]          = index;
+
+        // Extend the previous run if this draw only differs by its transform
+        if (instancing_ && runCount > 0) {
+            InstancedDraw &run    = instancedDraws_[runCount - 1];
+            const RenderObject &o = *run.object;
+            if (o.material == r.material && o.indexBuffer == r.indexBuffer && o.vertexBufferAddress == r.vertexBufferAddress &&
+                o.firstIndex == r.firstIndex && o.indexCount == r.indexCount && o.vertexOffset == r.vertexOffset) {
+                run.instanceCount++;
+                continue;
             }
+        }
+        instancedDraws_[runCount++] = {&r, i, 1};
+    }
+    instancedOpaqueCount_ = runCount;
+
+    // Transparent draws follow the opaque ones in the transform buffer
+    const uint32_t opaqueCount = static_cast<uint32_t>(drawCtx_.opaqueSurfaces.size());
+    for (uint32_t i = visibleOpaqueCount_; i < visibleCount_; ++i) {
+        const uint32_t index        = visibleDraws_[i];
+        instances[i]                = opaqueCount + index;
+        instancedDraws_[runCount++] = {&drawCtx_.transparentSurfaces[index], i, 1};
+    }
+    instancedDrawCount_ = runCount;
+
+    VK_CHECK(vmaFlushAllocation(allocator_, frame.instanceBuffer.allocation, 0, visibleCount_ * sizeof(uint32_t)));
+}
+
+void JVKEngine::recordDraws(VkCommandBuffer cmd, const uint32_t first, const uint32_t last, const bool transparent, int &drawCount, int &triangleCount) {
+    const FrameData &frame           = getCurrentFrame();
+    MaterialPipeline *lastPipeline   = nullptr;
+    VkBuffer lastIndexBuffer         = VK_NULL_HANDLE;
+    VkDeviceAddress lastVertexBuffer = 0;
+    uint32_t lastMaterialIndex       = ~0u;
+
+    auto draw = [&](const InstancedDraw &d) {
+        const RenderObject &r = *d.object;
+
+        // Rebind pipeline and global descriptors if the pipeline is different.
+        // Materials are selected by index, so they need no binds of their own.
+        if (r.material->pipeline != lastPipeline) {
+            lastPipeline      = r.material->pipeline;
+            lastVertexBuffer  = 0;
+            lastMaterialIndex = ~0u;
+
+            const VkDescriptorSet sets[] = {frame.sceneDataDescriptorSet, bindless_.set};
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r.material->pipeline->pipeline);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r.material->pipeline->pipelineLayout, 0, 2, sets, 0, nullptr);
+            setViewportScissor(cmd);
+        }
+
+        // Push buffer addresses
+        if (r.vertexBufferAddress != lastVertexBuffer) {
+            lastVertexBuffer = r.vertexBufferAddress;
+
+            const VkDeviceAddress addresses[] = {r.vertexBufferAddress, frame.transformAddress, frame.instanceAddress};
+            vkCmdPushConstants(cmd, r.material->pipeline->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof(GPUDrawPushConstants, vertexBuffer), sizeof(addresses), addresses);
+        }
 
-            // Bind material descriptor set
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r.material->pipeline->pipelineLayout, 1, 1, &r.material->materialSet, 0, nullptr);
+        // Push material index
+        if (r.material->materialIndex != lastMaterialIndex) {
+            lastMaterialIndex = r.material->materialIndex;
+            vkCmdPushConstants(cmd, r.material->pipeline->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof(GPUDrawPushConstants, materialIndex), sizeof(uint32_t), &lastMaterialIndex);
         }
 
         // Bind index buffer
@@ -720,32 +1300,41 @@ void JVKEngine::drawGeometry(VkCommandBuffer cmd) {
             vkCmdBindIndexBuffer(cmd, r.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
         }
 
-        // Push constants
-        GPUDrawPushConstants pushConstants;
-        pushConstants.vertexBuffer = r.vertexBufferAddress;
-        pushConstants.worldMatrix  = r.transform;
-        vkCmdPushConstants(cmd, r.material->pipeline->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(GPUDrawPushConstants), &pushConstants);
-
         // Draw
-        vkCmdDrawIndexed(cmd, r.indexCount, 1, r.firstIndex, 0, 0);
+        vkCmdDrawIndexed(cmd, r.indexCount, d.instanceCount, r.firstIndex, r.vertexOffset, d.firstInstance);
 
-        stats_.drawCallCount++;
-        stats_.triangleCount += r.indexCount / 3;
+        drawCount++;
+        triangleCount += r.indexCount / 3 * d.instanceCount;
     };
 
-    for (const auto &r: opaqueDraws) {
-        draw(drawCtx_.opaqueSurfaces[r]);
+    for (uint32_t i = first; i < last; ++i) {
+        draw(instancedDraws_[i]);
     }
 
-    for (const RenderObject &r: drawCtx_.transparentSurfaces) {
-        draw(r);
+    if (transparent) {
+        for (uint32_t i = instancedOpaqueCount_; i < instancedDrawCount_; ++i) {
+            draw(instancedDraws_[i]);
+        }
     }
+}
 
-    vkCmdEndRendering(cmd);
-
-    auto end            = std::chrono::system_clock::now();
-    auto elapsed        = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    stats_.meshDrawTime = elapsed.count() / 1000.0f;
+void JVKEngine::setViewportScissor(VkCommandBuffer cmd) const {
+    VkViewport viewport{};
+    viewport.x        = 0;
+    viewport.y        = 0;
+    viewport.width    = drawExtent_.width;
+    viewport.height   = drawExtent_.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+    // SCISSOR
+    VkRect2D scissor{};
+    scissor.offset.x      = 0;
+    scissor.offset.y      = 0;
+    scissor.extent.width  = drawExtent_.width;
+    scissor.extent.height = drawExtent_.height;
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
 }
 
 jvk::Buffer JVKEngine::createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage) const {
@@ -764,60 +1353,49 @@ jvk::Buffer JVKEngine::createBuffer(size_t allocSize, VkBufferUsageFlags usage,
     return buffer;
 }
 
+VkDeviceAddress JVKEngine::getBufferAddress(const VkBuffer buffer) const {
+    VkBufferDeviceAddressInfo deviceAddressInfo{};
+    deviceAddressInfo.sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    deviceAddressInfo.buffer = buffer;
+    return vkGetBufferDeviceAddress(ctx_.device, &deviceAddressInfo);
+}
+
 void JVKEngine::destroyBuffer(const jvk::Buffer &buffer) const {
     buffer.destroy(allocator_);
 }
 
-GPUMeshBuffers JVKEngine::uploadMesh(std::span<uint32_t> indices, std::span<Vertex> vertices) const {
+GPUMeshBuffers JVKEngine::uploadMesh(const std::span<const uint32_t> indices, const std::span<const Vertex> vertices) {
     const size_t vertexBufferSize = vertices.size() * sizeof(Vertex);
     const size_t indexBufferSize  = indices.size() * sizeof(uint32_t);
 
-    GPUMeshBuffers surface;
-
-    // CREATE BUFFERS
-    // Vertex buffer
-    surface.vertexBuffer = createBuffer(vertexBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-
-    // Vertex buffer address
-    VkBufferDeviceAddressInfo deviceAddressInfo{};
-    deviceAddressInfo.sType     = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-    deviceAddressInfo.buffer    = surface.vertexBuffer.buffer;
-    surface.vertexBufferAddress = vkGetBufferDeviceAddress(ctx_.device, &deviceAddressInfo);
-
-    // Index buffer
-    surface.indexBuffer = createBuffer(indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-
-    // STAGING BUFFER
-    jvk::Buffer staging = createBuffer(vertexBufferSize + indexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-    void *data              = staging.allocation->GetMappedData();
-
-    // COPY DATA TO STAGING BUFFER
-    memcpy(data, vertices.data(), vertexBufferSize);
-    memcpy(static_cast<char *>(data) + vertexBufferSize, indices.data(), indexBufferSize);
-
-    // COPY TO GPU BUFFER
-    immBuffer_.submit(graphicsQueue_, [&](VkCommandBuffer cmd) {
-        // COPY VERTEX DATA
-        VkBufferCopy vertexCopy{0};
-        vertexCopy.dstOffset = 0;
-        vertexCopy.srcOffset = 0;
-        vertexCopy.size      = vertexBufferSize;
-        vkCmdCopyBuffer(cmd, staging.buffer, surface.vertexBuffer.buffer, 1, &vertexCopy);
-
-        // COPY INDEX DATA
-        VkBufferCopy indexCopy{0};
-        indexCopy.dstOffset = 0;
-        indexCopy.srcOffset = vertexBufferSize;
-        indexCopy.size      = indexBufferSize;
-        vkCmdCopyBuffer(cmd, staging.buffer, surface.indexBuffer.buffer, 1, &indexCopy);
-    });
+    // ARENA ALLOCATION
+    auto allocation = geometryArena_.allocate(static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()));
+    if (!allocation.has_value()) {
+        fmt::println("Geometry arena is full ({} / {} vertices, {} / {} indices); raise geometryArenaVertices_/geometryArenaIndices_",
+                     geometryArena_.vertices.used(), geometryArena_.vertices.capacity(), geometryArena_.indices.used(), geometryArena_.indices.capacity());
+        abort();
+    }
 
-    // DESTROY STAGING BUFFER
-    destroyBuffer(staging);
+    GPUMeshBuffers surface;
+    surface.id                  = meshBufferCount_++;
+    surface.allocation          = *allocation;
+    surface.indexBuffer         = geometryArena_.indexBuffer;
+    surface.vertexBufferAddress = geometryArena_.vertexBufferAddress;
+
+    // COPY TO ARENA
+    uploads_.uploadBuffer(geometryArena_.vertexBuffer, surface.allocation.vertexOffset * sizeof(Vertex), vertices.data(), vertexBufferSize);
+    uploads_.uploadBuffer(geometryArena_.indexBuffer, surface.allocation.firstIndex * sizeof(uint32_t), indices.data(), indexBufferSize);
     return surface;
 }
 
+void JVKEngine::freeMesh(const GPUMeshBuffers &mesh) {
+    geometryArena_.free(mesh.allocation);
+}
+
 void JVKEngine::initDefaultData() {
+    // GEOMETRY ARENA
+    geometryArena_.init(this, geometryArenaVertices_, geometryArenaIndices_);
+
     // TEXTURES
     // 1 pixel default textures
     uint32_t white = glm::packUnorm4x8(glm::vec4(1, 1, 1, 1));
@@ -840,46 +1418,123 @@ void JVKEngine::initDefaultData() {
     VK_CHECK(defaultSamplerNearest_.init(ctx_, VK_FILTER_NEAREST, VK_FILTER_NEAREST));
     VK_CHECK(defaultSamplerLinear_.init(ctx_, VK_FILTER_LINEAR, VK_FILTER_LINEAR));
 
-    // MATERIALS
-    GLTFMetallicRoughness::MaterialResources matResources;
-    matResources.colorImage               = whiteImage_;
-    matResources.colorSampler             = defaultSamplerLinear_;
-    matResources.metallicRoughnessImage   = whiteImage_;
-    matResources.metallicRoughnessSampler = defaultSamplerLinear_;
-
-    matConstants_                                              = createBuffer(sizeof(GLTFMetallicRoughness::MaterialConstants), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-    GLTFMetallicRoughness::MaterialConstants *sceneUniformData = static_cast<GLTFMetallicRoughness::MaterialConstants *>(matConstants_.allocation->GetMappedData());
-    sceneUniformData->colorFactors                             = glm::vec4{1, 1, 1, 1};
-    sceneUniformData->metallicRoughnessFactors                 = glm::vec4{1, 0.5, 0, 0};
-
-    matResources.dataBuffer       = matConstants_.buffer;
-    matResources.dataBufferOffset = 0;
+    // BINDLESS SLOTS
+    whiteImageIndex_             = bindless_.addTexture(whiteImage_.imageView);
+    blackImageIndex_             = bindless_.addTexture(blackImage_.imageView);
+    errorCheckerboardImageIndex_ = bindless_.addTexture(errorCheckerboardImage_.imageView);
+    defaultSamplerLinearIndex_   = bindless_.addSampler(defaultSamplerLinear_);
+    defaultSamplerNearestIndex_  = bindless_.addSampler(defaultSamplerNearest_);
 
-    defaultMaterialData_ = metallicRoughnessMaterial_.writeMaterial(ctx_.device, MaterialPass::MAIN_COLOR, matResources, globalDescriptorAllocator_);
+    // MATERIALS
+    GPUMaterial material{};
+    material.colorFactors             = glm::vec4{1, 1, 1, 1};
+    material.metallicRoughnessFactors = glm::vec4{1, 0.5, 0, 0};
+    material.colorTexture             = whiteImageIndex_;
+    material.colorSampler             = defaultSamplerLinearIndex_;
+    material.metallicRoughnessTexture = whiteImageIndex_;
+    material.metallicRoughnessSampler = defaultSamplerLinearIndex_;
+
+    defaultMaterialData_ = metallicRoughnessMaterial_.writeMaterial(bindless_, MaterialPass::MAIN_COLOR, material);
 }
 
 void JVKEngine::resizeSwapchain() {
     vkDeviceWaitIdle(ctx_);
     swapchain_.destroy(ctx_);
+    // Present ids of the old swapchain can no longer be waited on
+    latency_.dropPending();
 
     int w, h;
     SDL_GetWindowSize(window_, &w, &h);
     windowExtent_.width  = w;
     windowExtent_.height = h;
 
-    swapchain_.init(ctx_, windowExtent_.width, windowExtent_.height);
+    swapchain_.init(ctx_, windowExtent_.width, windowExtent_.height, VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR, presentMode_);
     resizeRequested_ = false;
 }
 
+void JVKEngine::setFramePacing(const FramePacing &pacing) {
+    vkDeviceWaitIdle(ctx_);
+    pacingRequested_ = false;
+
+    const uint32_t frameCount = std::clamp(pacing.frameCount, 1u, JVK_MAX_FRAMES);
+    for (uint32_t i = frameCount; i < frameCount_; ++i) {
+        releaseFrameBuffers(frames_[i]);
+    }
+    // Slots joining the rotation hold results from whenever they were last used
+    for (uint32_t i = frameCount_; i < frameCount; ++i) {
+        frames_[i].timestampsRecorded = false;
+        frames_[i].countsRecorded     = false;
+    }
+    frameCount_ = frameCount;
+
+    if (pacing.presentMode != presentMode_) {
+        presentMode_ = pacing.presentMode;
+        if (!headless_) {
+            resizeSwapchain();
+        }
+    }
+}
+
+void JVKEngine::pollPresentation() {
+    latency_.poll([this](const LatencyTracker::PendingFrame &frame) {
+        if (presentWaitSupported_) {
+            return waitForPresent_(ctx_, swapchain_.swapchain, frame.presentId, 0) == VK_SUCCESS;
+        }
+        return graphicsTimeline_.isComplete(frame.timelineValue);
+    });
+}
+
+void JVKEngine::deferDestroy(const uint64_t value, std::function<void()> &&destroy) {
+    deletionQueue_.emplace_back(value, std::move(destroy));
+}
+
+void JVKEngine::deferDestroy(std::function<void()> &&destroy) {
+    deferDestroy(graphicsTimeline_.submitted, std::move(destroy));
+}
+
+void JVKEngine::collectGarbage() {
+    if (deletionQueue_.empty()) return;
+
+    // Values are queued in increasing order, so stop at the first one not reached
+    const uint64_t completed = graphicsTimeline_.value();
+    while (!deletionQueue_.empty() && deletionQueue_.front().first <= completed) {
+        deletionQueue_.front().second();
+        deletionQueue_.pop_front();
+    }
+}
+
+void JVKEngine::releaseFrameBuffers(FrameData &frame) const {
+    if (frame.transformCapacity > 0) {
+        frame.transformBuffer.destroy(allocator_);
+        frame.instanceBuffer.destroy(allocator_);
+        frame.transformCapacity = 0;
+        frame.transformVersion  = 0;
+    }
+    frame.movedTransforms.clear();
+    if (frame.drawCapacity > 0) {
+        frame.drawDataBuffer.destroy(allocator_);
+        frame.indirectBuffer.destroy(allocator_);
+        frame.drawCapacity    = 0;
+        frame.drawListVersion = 0;
+    }
+    frame.movedDraws.clear();
+    if (frame.countCapacity > 0) {
+        frame.countBuffer.destroy(allocator_);
+        frame.countCapacity = 0;
+    }
+}
+
 jvk::Image JVKEngine::createImage(const VkExtent3D size, const VkFormat format, const VkImageUsageFlags usage, const bool mipmapped, const VkSampleCountFlagBits sampleCount) const {
+    return allocateImage(size, format, usage, mipmapped ? jvk::mipLevelCount({size.width, size.height}) : 1, sampleCount);
+}
+
+jvk::Image JVKEngine::allocateImage(const VkExtent3D size, const VkFormat format, const VkImageUsageFlags usage, const uint32_t levelCount, const VkSampleCountFlagBits sampleCount) const {
     // IMAGE
     jvk::Image image;
     image.imageFormat           = format;
     image.imageExtent           = size;
     VkImageCreateInfo imageInfo = jvk::init::image(format, usage, size, sampleCount);
-    if (mipmapped) {
-        imageInfo.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(size.width, size.height)))) + 1;
-    }
+    imageInfo.mipLevels         = levelCount;
 
     // ALLOCATE
     VmaAllocationCreateInfo allocInfo{};
@@ -901,11 +1556,8 @@ jvk::Image JVKEngine::createImage(const VkExtent3D size, const VkFormat format,
     return image;
 }
 
-jvk::Image JVKEngine::createImage(void *data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped) const {
-    // STAGING BUFFER
-    size_t dataSize              = size.depth * size.width * size.height * 4;
-    jvk::Buffer uploadBuffer = createBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-    memcpy(uploadBuffer.info.pMappedData, data, dataSize);
+jvk::Image JVKEngine::createImage(void *data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped) {
+    const VkDeviceSize dataSize = jvk::mipLevelSize(format, size, 0);
 
     // COPY TO IMAGE
     VkImageUsageFlags imgUsages = VK_IMAGE_USAGE_TRANSFER_DST_BIT | usage;
@@ -914,44 +1566,71 @@ jvk::Image JVKEngine::createImage(void *data, VkExtent3D size, VkFormat format,
     }
 
     jvk::Image image = createImage(size, format, imgUsages, mipmapped);
-    immBuffer_.submit(graphicsQueue_.queue, [&](VkCommandBuffer cmd) {
-        jvk::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        VkBufferImageCopy copyRegion{};
-        copyRegion.bufferOffset      = 0;
-        copyRegion.bufferRowLength   = 0;
-        copyRegion.bufferImageHeight = 0;
-
-        copyRegion.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.mipLevel       = 0;
-        copyRegion.imageSubresource.baseArrayLayer = 0;
-        copyRegion.imageSubresource.layerCount     = 1;
-        copyRegion.imageExtent                     = size;
-
-        vkCmdCopyBufferToImage(cmd, uploadBuffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+    uploads_.uploadImage(image, data, dataSize, mipmapped);
+    return image;
+}
 
-        if (mipmapped) {
-            jvk::generateMipmaps(cmd, image.image, {image.imageExtent.width, image.imageExtent.height});
-        } else {
-            jvk::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        }
-    });
+jvk::Image JVKEngine::createImage(const void *data, const VkExtent3D size, const VkFormat format, const VkImageUsageFlags usage, const uint32_t levelCount) {
+    assert(levelCount >= 1 && levelCount <= jvk::mipLevelCount({size.width, size.height}));
 
-    destroyBuffer(uploadBuffer);
+    jvk::Image image = allocateImage(size, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT | usage, levelCount);
+    uploads_.uploadImageLevels(image, data, jvk::mipChainSize(format, size, levelCount), levelCount);
     return image;
 }
 
 void JVKEngine::updateScene() {
-    auto start = std::chrono::system_clock::now();
+    auto start = std::chrono::steady_clock::now();
 
     mainCamera_.update(deltaTime_);
     glm::mat4 view = mainCamera_.getViewMatrix();
     glm::mat4 proj = glm::perspective(glm::radians(70.f), static_cast<float>(windowExtent_.width) / static_cast<float>(windowExtent_.height), 0.1f, 10000.0f);
     proj[1][1] *= -1;
 
-    drawCtx_.opaqueSurfaces.clear();
-    drawCtx_.transparentSurfaces.clear();
-    loadedScenes_["base_scene"]->draw(glm::mat4(1.0f), drawCtx_);
+    // Scenes keep retained draw lists; only re-merge when one of them was rebuilt
+    for (const auto &[name, scene]: loadedScenes_) {
+        scene->update();
+        drawListDirty_ |= scene->drawListDirty;
+    }
+
+    if (drawListDirty_) {
+        drawCtx_.clear();
+        for (const auto &[name, scene]: loadedScenes_) {
+            scene->mergedOpaqueBase      = static_cast<uint32_t>(drawCtx_.opaqueSurfaces.size());
+            scene->mergedTransparentBase = static_cast<uint32_t>(drawCtx_.transparentSurfaces.size());
+            drawCtx_.opaqueSurfaces.insert(drawCtx_.opaqueSurfaces.end(), scene->drawCtx.opaqueSurfaces.begin(), scene->drawCtx.opaqueSurfaces.end());
+            drawCtx_.transparentSurfaces.insert(drawCtx_.transparentSurfaces.end(), scene->drawCtx.transparentSurfaces.begin(), scene->drawCtx.transparentSurfaces.end());
+            scene->drawListDirty = false;
+            scene->movedDraws.clear();
+        }
+        drawListDirty_ = false;
+
+        // World-space bounds only change with the draw list
+        const size_t opaqueCount = drawCtx_.opaqueSurfaces.size();
+        opaqueSpheres_.resize(opaqueCount);
+        jobs_.parallelFor(static_cast<uint32_t>(opaqueCount), JVK_MIN_SPHERES_PER_JOB, [&](const uint32_t first, const uint32_t last) {
+            for (uint32_t i = first; i < last; ++i) {
+                const RenderObject &r = drawCtx_.opaqueSurfaces[i];
+                opaqueSpheres_.set(i, r.transform, r.bounds);
+            }
+        });
+        transparentSpheres_.resize(drawCtx_.transparentSurfaces.size());
+        for (size_t i = 0; i < drawCtx_.transparentSurfaces.size(); ++i) {
+            const RenderObject &r = drawCtx_.transparentSurfaces[i];
+            transparentSpheres_.set(i, r.transform, r.bounds);
+        }
+        visibleDraws_.resize(opaqueSpheres_.count + transparentSpheres_.count);
+
+        sortKeys_.resize(opaqueCount);
+        sortKeysTmp_.resize(opaqueCount);
+        sortedDraws_.resize(opaqueCount);
+        sortedDrawsTmp_.resize(opaqueCount);
+        instancedDraws_.resize(visibleDraws_.size());
+
+        buildIndirectBatches();
+        drawListVersion_++;
+    } else {
+        patchMovedDraws();
+    }
 
     sceneData_.view              = view;
     sceneData_.proj              = proj;
@@ -960,11 +1639,313 @@ void JVKEngine::updateScene() {
     sceneData_.sunlightColor     = glm::vec4(1.0f);
     sceneData_.sunlightDirection = glm::vec4(0, 1, 0.5, 1.0f);
 
-    auto end               = std::chrono::system_clock::now();
+    cullDraws();
+
+    auto end               = std::chrono::steady_clock::now();
     auto elapsed           = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     stats_.sceneUpdateTime = elapsed.count() / 1000.0f;
 }
 
+void JVKEngine::cullDraws() {
+    const Frustum frustum = Frustum::fromViewProj(sceneData_.viewProj);
+
+    const auto cull = [&](const CullingSpheres &spheres, uint32_t *visible) {
+        if (frustumCulling_) {
+            return cullSpheres(frustum, spheres, visible);
+        }
+        for (uint32_t i = 0; i < spheres.count; ++i) {
+            visible[i] = i;
+        }
+        return spheres.count;
+    };
+
+    // GPU-driven: opaque draws are culled by cull.comp instead
+    visibleOpaqueCount_ = gpuDrivenRendering_ ? 0 : cull(opaqueSpheres_, visibleDraws_.data());
+    visibleCount_       = visibleOpaqueCount_ + cull(transparentSpheres_, visibleDraws_.data() + visibleOpaqueCount_);
+
+    // GPU counts lag behind by frameCount_
+    const uint32_t visible = gpuDrivenRendering_ ? visibleCount_ + gpuVisibleDraws_ : visibleCount_;
+    stats_.visibleCount    = static_cast<int>(visible);
+    stats_.culledCount     = static_cast<int>(opaqueSpheres_.count + transparentSpheres_.count - visible);
+}
+
+void JVKEngine::patchMovedDraws() {
+    const uint32_t opaqueCount = static_cast<uint32_t>(drawCtx_.opaqueSurfaces.size());
+    const uint32_t objectCount = opaqueCount + static_cast<uint32_t>(drawCtx_.transparentSurfaces.size());
+
+    movedObjects_.clear();
+    for (const auto &[name, scene]: loadedScenes_) {
+        for (const DrawRef &ref: scene->movedDraws) {
+            if (ref.transparent) {
+                const uint32_t index = scene->mergedTransparentBase + ref.index;
+                RenderObject &r      = drawCtx_.transparentSurfaces[index];
+                r.transform          = scene->drawCtx.transparentSurfaces[ref.index].transform;
+                transparentSpheres_.set(index, r.transform, r.bounds);
+                movedObjects_.push_back(opaqueCount + index);
+            } else {
+                const uint32_t index = scene->mergedOpaqueBase + ref.index;
+                RenderObject &r      = drawCtx_.opaqueSurfaces[index];
+                r.transform          = scene->drawCtx.opaqueSurfaces[ref.index].transform;
+                opaqueSpheres_.set(index, r.transform, r.bounds);
+                gpuDraws_[index].boundingSphere = glm::vec4(opaqueSpheres_.centerX[index], opaqueSpheres_.centerY[index], opaqueSpheres_.centerZ[index], opaqueSpheres_.radius[index]);
+                movedObjects_.push_back(index);
+            }
+        }
+        scene->movedDraws.clear();
+    }
+    if (movedObjects_.empty()) return;
+
+    // Every frame in flight holds its own copy, so each catches up when it is next prepared.
+    // Frames with stale buffers rewrite them whole anyway, as do frames that fell too far behind.
+    for (uint32_t i = 0; i < frameCount_; ++i) {
+        FrameData &frame = frames_[i];
+        if (frame.transformVersion == drawListVersion_) {
+            frame.movedTransforms.insert(frame.movedTransforms.end(), movedObjects_.begin(), movedObjects_.end());
+            if (frame.movedTransforms.size() > objectCount) {
+                frame.movedTransforms.clear();
+                frame.transformVersion = 0;
+            }
+        }
+        if (frame.drawListVersion == drawListVersion_) {
+            for (const uint32_t object: movedObjects_) {
+                if (object < opaqueCount) frame.movedDraws.push_back(object);
+            }
+            if (frame.movedDraws.size() > opaqueCount) {
+                frame.movedDraws.clear();
+                frame.drawListVersion = 0;
+            }
+        }
+    }
+}
+
+void JVKEngine::buildIndirectBatches() {
+    // Draws keep their merged order, so gpuDraws_[i] is opaque surface i. Runs sharing an
+    // index buffer form a batch owning a contiguous command range; with the geometry arena
+    // that is a single batch, so nothing needs sorting.
+    const size_t drawCount = drawCtx_.opaqueSurfaces.size();
+    gpuDraws_.resize(drawCount);
+    indirectBatches_.clear();
+    for (uint32_t i = 0; i < drawCount; ++i) {
+        const RenderObject &r = drawCtx_.opaqueSurfaces[i];
+
+        if (indirectBatches_.empty() || indirectBatches_.back().indexBuffer != r.indexBuffer) {
+            indirectBatches_.push_back({r.indexBuffer, i, 0});
+        }
+        IndirectBatch &batch = indirectBatches_.back();
+        batch.drawCount++;
+
+        GPUDrawData &draw   = gpuDraws_[i];
+        draw.boundingSphere = glm::vec4(opaqueSpheres_.centerX[i], opaqueSpheres_.centerY[i], opaqueSpheres_.centerZ[i], opaqueSpheres_.radius[i]);
+        draw.vertexBuffer   = r.vertexBufferAddress;
+        draw.indexCount     = r.indexCount;
+        draw.firstIndex     = r.firstIndex;
+        draw.vertexOffset   = r.vertexOffset;
+        draw.materialIndex  = r.material->materialIndex;
+        draw.objectIndex    = i;
+        draw.batch          = static_cast<uint32_t>(indirectBatches_.size() - 1);
+        draw.commandOffset  = batch.firstCommand;
+    }
+}
+
+void JVKEngine::readIndirectCounts() {
+    FrameData &frame = getCurrentFrame();
+    if (!frame.countsRecorded) return;
+
+    VK_CHECK(vmaInvalidateAllocation(allocator_, frame.countBuffer.allocation, 0, VK_WHOLE_SIZE));
+    const uint32_t *counts = static_cast<const uint32_t *>(frame.countBuffer.info.pMappedData);
+    gpuVisibleDraws_       = counts[frame.recordedBatches];
+    gpuVisibleTriangles_   = counts[frame.recordedBatches + 1];
+    frame.countsRecorded   = false;
+}
+
+void JVKEngine::prepareTransforms() {
+    FrameData &frame         = getCurrentFrame();
+    const size_t opaqueCount = drawCtx_.opaqueSurfaces.size();
+    const size_t objectCount = opaqueCount + drawCtx_.transparentSurfaces.size();
+
+    // This frame's fence has been waited on, so its buffer can be replaced or rewritten
+    if (frame.transformVersion == drawListVersion_) {
+        if (frame.movedTransforms.empty()) return;
+
+        glm::mat4 *transforms = static_cast<glm::mat4 *>(frame.transformBuffer.info.pMappedData);
+        for (const uint32_t object: frame.movedTransforms) {
+            transforms[object] = object < opaqueCount ? drawCtx_.opaqueSurfaces[object].transform : drawCtx_.transparentSurfaces[object - opaqueCount].transform;
+        }
+        VK_CHECK(vmaFlushAllocation(allocator_, frame.transformBuffer.allocation, 0, VK_WHOLE_SIZE));
+        frame.movedTransforms.clear();
+        return;
+    }
+    frame.movedTransforms.clear();
+
+    if (objectCount > frame.transformCapacity) {
+        if (frame.transformCapacity > 0) {
+            frame.transformBuffer.destroy(allocator_);
+            frame.instanceBuffer.destroy(allocator_);
+        }
+        frame.transformCapacity = objectCount;
+
+        frame.transformBuffer  = createBuffer(objectCount * sizeof(glm::mat4), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        frame.instanceBuffer   = createBuffer(objectCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        frame.transformAddress = getBufferAddress(frame.transformBuffer);
+        frame.instanceAddress  = getBufferAddress(frame.instanceBuffer);
+    }
+
+    if (objectCount > 0) {
+        glm::mat4 *transforms = static_cast<glm::mat4 *>(frame.transformBuffer.info.pMappedData);
+        for (size_t i = 0; i < opaqueCount; ++i) {
+            transforms[i] = drawCtx_.opaqueSurfaces[i].transform;
+        }
+        for (size_t i = 0; i < drawCtx_.transparentSurfaces.size(); ++i) {
+            transforms[opaqueCount + i] = drawCtx_.transparentSurfaces[i].transform;
+        }
+        VK_CHECK(vmaFlushAllocation(allocator_, frame.transformBuffer.allocation, 0, VK_WHOLE_SIZE));
+    }
+    frame.transformVersion = drawListVersion_;
+}
+
+void JVKEngine::prepareIndirectBuffers() {
+    FrameData &frame = getCurrentFrame();
+
+    // This frame's fence has been waited on, so its buffers can be replaced or rewritten
+    if (frame.drawListVersion == drawListVersion_) {
+        if (frame.movedDraws.empty()) return;
+
+        GPUDrawData *draws = static_cast<GPUDrawData *>(frame.drawDataBuffer.info.pMappedData);
+        for (const uint32_t draw: frame.movedDraws) {
+            draws[draw].boundingSphere = gpuDraws_[draw].boundingSphere;
+        }
+        VK_CHECK(vmaFlushAllocation(allocator_, frame.drawDataBuffer.allocation, 0, VK_WHOLE_SIZE));
+        frame.movedDraws.clear();
+        return;
+    }
+    frame.movedDraws.clear();
+
+    const size_t drawCount  = gpuDraws_.size();
+    const size_t countCount = indirectBatches_.size() + 2;
+
+    if (drawCount > frame.drawCapacity) {
+        if (frame.drawCapacity > 0) {
+            frame.drawDataBuffer.destroy(allocator_);
+            frame.indirectBuffer.destroy(allocator_);
+        }
+        frame.drawCapacity = drawCount;
+
+        frame.drawDataBuffer  = createBuffer(drawCount * sizeof(GPUDrawData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        frame.indirectBuffer  = createBuffer(drawCount * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+        frame.drawDataAddress = getBufferAddress(frame.drawDataBuffer);
+        frame.indirectAddress = getBufferAddress(frame.indirectBuffer);
+    }
+
+    if (countCount > frame.countCapacity) {
+        if (frame.countCapacity > 0) {
+            frame.countBuffer.destroy(allocator_);
+        }
+        frame.countCapacity = countCount;
+
+        frame.countBuffer  = createBuffer(countCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+        frame.countAddress = getBufferAddress(frame.countBuffer);
+    }
+
+    if (drawCount > 0) {
+        memcpy(frame.drawDataBuffer.info.pMappedData, gpuDraws_.data(), drawCount * sizeof(GPUDrawData));
+        VK_CHECK(vmaFlushAllocation(allocator_, frame.drawDataBuffer.allocation, 0, VK_WHOLE_SIZE));
+    }
+    frame.drawListVersion = drawListVersion_;
+}
+
+void JVKEngine::dispatchCulling(VkCommandBuffer cmd) {
+    FrameData &frame          = getCurrentFrame();
+    const uint32_t drawCount  = static_cast<uint32_t>(gpuDraws_.size());
+    const uint32_t batchCount = static_cast<uint32_t>(indirectBatches_.size());
+    if (drawCount == 0) {
+        // Nothing is culled, so counts from an earlier draw list must not linger in the stats
+        gpuVisibleDraws_     = 0;
+        gpuVisibleTriangles_ = 0;
+        frame.countsRecorded = false;
+        return;
+    }
+
+    // RESET COUNTS
+    vkCmdFillBuffer(cmd, frame.countBuffer, 0, (batchCount + 2) * sizeof(uint32_t), 0);
+    jvk::memoryBarrier(cmd, VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    // CULL
+    CullPushConstants pushConstants;
+    if (frustumCulling_) {
+        const Frustum frustum = Frustum::fromViewProj(sceneData_.viewProj);
+        for (int i = 0; i < 6; ++i) {
+            pushConstants.frustumPlanes[i] = frustum.planes[i];
+        }
+    } else {
+        // Planes every sphere is in front of
+        for (glm::vec4 &plane: pushConstants.frustumPlanes) {
+            plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+    }
+    pushConstants.drawData      = frame.drawDataAddress;
+    pushConstants.commandBuffer = frame.indirectAddress;
+    pushConstants.countBuffer   = frame.countAddress;
+    pushConstants.drawCount     = drawCount;
+    pushConstants.batchCount    = batchCount;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline_);
+    vkCmdPushConstants(cmd, cullPipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants), &pushConstants);
+    vkCmdDispatch(cmd, (drawCount + 63) / 64, 1, 1);
+
+    // Commands & counts feed the indirect draws, and the counts are read back for stats
+    jvk::memoryBarrier(cmd, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                       VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_HOST_READ_BIT);
+
+    frame.recordedBatches = batchCount;
+    frame.countsRecorded  = true;
+}
+
+void JVKEngine::recordIndirectDraws(VkCommandBuffer cmd, int &drawCount) {
+    if (indirectBatches_.empty()) return;
+
+    const FrameData &frame           = getCurrentFrame();
+    const MaterialPipeline &pipeline = metallicRoughnessMaterial_.indirectPipeline;
+
+    const VkDescriptorSet sets[] = {frame.sceneDataDescriptorSet, bindless_.set};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipelineLayout, 0, 2, sets, 0, nullptr);
+    setViewportScissor(cmd);
+
+    // mesh_indirect.vert reads the draw data address from the vertex buffer slot
+    const VkDeviceAddress addresses[] = {frame.drawDataAddress, frame.transformAddress};
+    vkCmdPushConstants(cmd, pipeline.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof(GPUDrawPushConstants, vertexBuffer), sizeof(addresses), addresses);
+
+    VkBuffer lastIndexBuffer = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < indirectBatches_.size(); ++i) {
+        const IndirectBatch &batch = indirectBatches_[i];
+
+        if (batch.indexBuffer != lastIndexBuffer) {
+            lastIndexBuffer = batch.indexBuffer;
+            vkCmdBindIndexBuffer(cmd, batch.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        }
+
+        vkCmdDrawIndexedIndirectCount(cmd, frame.indirectBuffer, batch.firstCommand * sizeof(VkDrawIndexedIndirectCommand),
+                                      frame.countBuffer, i * sizeof(uint32_t), batch.drawCount, sizeof(VkDrawIndexedIndirectCommand));
+        drawCount++;
+    }
+}
+
+void JVKEngine::addScene(const std::string &name, const std::shared_ptr<LoadedGLTF> &scene) {
+    loadedScenes_[name] = scene;
+    drawListDirty_      = true;
+}
+
+void JVKEngine::removeScene(const std::string &name) {
+    const auto it = loadedScenes_.find(name);
+    if (it == loadedScenes_.end()) return;
+
+    // In-flight frames may still reference the scene's buffers & descriptors
+    deferDestroy([scene = it->second] {});
+    loadedScenes_.erase(it);
+    drawListDirty_ = true;
+}
+
 VkSampleCountFlagBits JVKEngine::getMaxUsableSampleCount() {
     VkPhysicalDeviceProperties props;
     vkGetPhysicalDeviceProperties(ctx_, &props);
@@ -7,12 +7,18 @@
 #include <jvk.hpp>
 #include <immediate.hpp>
 #include <mesh.hpp>
+#include <culling.hpp>
+#include <sorting.hpp>
+#include <jobs.hpp>
+#include <latency.hpp>
+#include <upload.hpp>
 
 #include <jvk/commands.hpp>
 #include <jvk/context.hpp>
 #include <jvk/fence.hpp>
 #include <jvk/image.hpp>
 #include <jvk/queue.hpp>
+#include <jvk/query.hpp>
 #include <jvk/semaphore.hpp>
 #include <jvk/swapchain.hpp>
 #include <jvk/descriptor.hpp>
@@ -33,29 +39,143 @@ struct ComputeEffect {
     ComputePushConstants data;
 };
 
+/**
+ * GPU passes bracketed by a begin/end timestamp pair each frame
+ */
+enum GPUPass : uint32_t {
+    GPU_PASS_BACKGROUND,
+    GPU_PASS_CULL,
+    GPU_PASS_GEOMETRY,
+    GPU_PASS_BLIT,
+    GPU_PASS_IMGUI,
+    GPU_PASS_COUNT
+};
+
+constexpr const char *GPU_PASS_NAMES[GPU_PASS_COUNT] = {"background", "cull", "geometry", "blit", "imgui"};
+
+/**
+ * Push constants of shaders/cull.comp
+ */
+struct CullPushConstants {
+    glm::vec4 frustumPlanes[6];
+    VkDeviceAddress drawData;
+    VkDeviceAddress commandBuffer;
+    VkDeviceAddress countBuffer;
+    uint32_t drawCount;
+    uint32_t batchCount;
+};
+
+/**
+ * Opaque draws sharing an index buffer (with the geometry arena, all of them). The
+ * culling pass appends the visible ones to the batch's command range
+ * [firstCommand, firstCommand + drawCount); the batch is then issued with a single
+ * vkCmdDrawIndexedIndirectCount. Materials are selected per draw in the shaders.
+ */
+struct IndirectBatch {
+    VkBuffer indexBuffer;
+    uint32_t firstCommand;
+    uint32_t drawCount;
+};
+
+/**
+ * A run of sorted draws of the same surface (index range) and material, issued as one
+ * instanced vkCmdDrawIndexed. Entries [firstInstance, firstInstance + instanceCount) of
+ * the frame's instance buffer hold the transform buffer slots of the instances.
+ */
+struct InstancedDraw {
+    const RenderObject *object;// First of the run; its state is shared by the rest
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+// Upper bound on threads recording geometry in parallel (workers + the main thread)
+constexpr uint32_t JVK_MAX_RECORD_THREADS = 16;
+// Fewer opaque draws per thread than this are not worth a secondary command buffer
+constexpr uint32_t JVK_MIN_DRAWS_PER_THREAD = 256;
+// Bounding spheres rebuilt per job on re-merge
+constexpr uint32_t JVK_MIN_SPHERES_PER_JOB = 1024;
+
 struct FrameData {
     // FRAME COMMANDS
     jvk::CommandPool cmdPool;
     jvk::CommandBuffer cmdBuffer;
 
+    // Per recording thread: a transient pool with one secondary command buffer,
+    // reset as a whole once timelineValue has been reached
+    jvk::CommandPool recordPools[JVK_MAX_RECORD_THREADS];
+    jvk::CommandBuffer recordBuffers[JVK_MAX_RECORD_THREADS];
+
     // FRAME SYNC
     // Semaphores:
     //  1. To have render commands wait on swapchain image request
     //  2. Control presentation of rendered image to OS after draw
-    // Fences:
-    //  1. Wait for draw commands of a submitted cmd buffer to be finished
+    // Timeline:
+    //  1. JVKEngine::graphicsTimeline_ value signaled once the frame's draw commands are finished
     jvk::Semaphore swapchainSemaphore;
     jvk::Semaphore renderSemaphore;
-    jvk::Fence renderFence;
+    uint64_t timelineValue = 0;
 
     // GLOBAL FRAME SCENE DATA
     jvk::Buffer sceneDataBuffer;
     VkDescriptorSet sceneDataDescriptorSet;
 
+    // OBJECT TRANSFORMS
+    // World matrix of every surface in the merged draw list (opaque, then transparent),
+    // indexed by the objectIndex draws push. Persistently mapped; rewritten when the
+    // draw list is re-merged, otherwise only the movedTransforms slots are.
+    jvk::Buffer transformBuffer;
+    VkDeviceAddress transformAddress = 0;
+    size_t transformCapacity         = 0;
+    uint64_t transformVersion        = 0;
+    std::vector<uint32_t> movedTransforms;
+
+    // Transform buffer slot of each CPU-path instance, read through gl_InstanceIndex.
+    // Rewritten every frame after sorting; same capacity as the transform buffer.
+    jvk::Buffer instanceBuffer;
+    VkDeviceAddress instanceAddress = 0;
+
     jvk::DynamicDescriptorAllocator descriptorAllocator;
+
+    // GPU TIMESTAMPS
+    // 2 queries per GPUPass; read back once timelineValue has been reached
+    jvk::QueryPool timestampPool;
+    bool timestampsRecorded = false;
+
+    // GPU-DRIVEN DRAWS
+    // drawDataBuffer is host-visible and rewritten when the retained draw list is re-merged;
+    // otherwise only the bounding spheres of movedDraws are.
+    // countBuffer holds one count per IndirectBatch plus total visible draws & triangles,
+    // read back once timelineValue has been reached.
+    jvk::Buffer drawDataBuffer;
+    jvk::Buffer indirectBuffer;
+    jvk::Buffer countBuffer;
+    VkDeviceAddress drawDataAddress;
+    VkDeviceAddress indirectAddress;
+    VkDeviceAddress countAddress;
+    size_t drawCapacity      = 0;
+    size_t countCapacity     = 0;
+    uint64_t drawListVersion = 0;
+    std::vector<uint32_t> movedDraws;
+    uint32_t recordedBatches = 0;
+    bool countsRecorded      = false;
+};
+
+// Frame slots created up front; JVKEngine::frameCount_ of them are in flight
+constexpr unsigned int JVK_MAX_FRAMES = 4;
+
+/**
+ * Frames in flight & present mode, applied with JVKEngine::setFramePacing()
+ */
+struct FramePacing {
+    uint32_t frameCount;
+    VkPresentModeKHR presentMode;
 };
 
-constexpr unsigned int JVK_NUM_FRAMES = 2;
+// The CPU waits for every frame and MAILBOX always shows the newest one
+constexpr FramePacing JVK_PACING_LOW_LATENCY = {1, VK_PRESENT_MODE_MAILBOX_KHR};
+constexpr FramePacing JVK_PACING_DEFAULT     = {2, VK_PRESENT_MODE_FIFO_KHR};
+// The CPU runs up to 3 frames ahead, never blocked by vsync
+constexpr FramePacing JVK_PACING_MAX_THROUGHPUT = {3, VK_PRESENT_MODE_IMMEDIATE_KHR};
 
 class JVKEngine {
 public:
@@ -64,17 +184,33 @@ public:
     bool stopRendering_ = false;
     VkExtent2D windowExtent_{1700, 900};
 
+    // HEADLESS
+    // Set before init(): skips SDL, the surface, swapchain, ImGui and presentation.
+    // Frames are rendered into drawImage_ only and can be read back afterwards.
+    bool headless_ = false;
+
+    std::string scenePath_ = "../assets/sponza.glb";
+
+    // ASSET CACHE
+    // glTF files are cooked into a .jvkc next to them when loaded; later loads map that instead
+    bool assetCache_ = true;
+
     float deltaTime_     = 1;
 
     jvk::Context ctx_;
     jvk::Swapchain swapchain_;
 
     // FRAME DATA
-    FrameData frames_[JVK_NUM_FRAMES];
-    FrameData &getCurrentFrame() { return frames_[frameNumber_ % JVK_NUM_FRAMES]; }
+    // Set before init(), or at runtime through setFramePacing()
+    FrameData frames_[JVK_MAX_FRAMES];
+    uint32_t frameCount_          = JVK_PACING_DEFAULT.frameCount;
+    VkPresentModeKHR presentMode_ = JVK_PACING_DEFAULT.presentMode;
+    FrameData &getCurrentFrame() { return frames_[frameNumber_ % frameCount_]; }
 
     // QUEUE
     jvk::Queue graphicsQueue_;
+    // A dedicated transfer queue family when the device has one, graphicsQueue_ otherwise
+    jvk::Queue transferQueue_;
 
     // MEMORY MANAGEMENT
     VmaAllocator allocator_;
@@ -99,6 +235,19 @@ public:
     // IMMEDIATE COMMANDS
     ImmediateBuffer immBuffer_;
 
+    // TIMELINE
+    // Every graphics queue submission (frames & immediate commands) signals the next value;
+    // work has finished once the value it signals is reached
+    jvk::TimelineSemaphore graphicsTimeline_;
+
+    // UPLOADS
+    // Batched on transferQueue_ through a staging ring; frames wait on the last submitted batch
+    UploadManager uploads_;
+
+    // DEFERRED DESTRUCTION
+    // In timeline order; run once the GPU reaches their value
+    std::deque<std::pair<uint64_t, std::function<void()>>> deletionQueue_;
+
     // IMGUI
     VkDescriptorPool imguiPool_;
 
@@ -114,29 +263,131 @@ public:
     jvk::Sampler defaultSamplerLinear_;
     jvk::Sampler defaultSamplerNearest_;
 
+    // Bindless slots of the images & samplers above
+    uint32_t whiteImageIndex_;
+    uint32_t blackImageIndex_;
+    uint32_t errorCheckerboardImageIndex_;
+    uint32_t defaultSamplerLinearIndex_;
+    uint32_t defaultSamplerNearestIndex_;
+
     VkDescriptorSetLayout singleImageDescriptorLayout_;
 
     // MATERIALS
+    // Every texture, sampler & material is registered in bindless_
+    BindlessTable bindless_;
     GLTFMetallicRoughness metallicRoughnessMaterial_;
     MaterialInstance defaultMaterialData_;
-    jvk::Buffer matConstants_;
 
     // SCENE
+    // Merged retained draw lists of all loaded scenes; re-merged only when scenes are
+    // added, removed or rebuilt. Moved RenderObjects are patched in place.
     DrawContext drawCtx_;
-    std::unordered_map<std::string, std::shared_ptr<Node>> loadedNodes_;
+    bool drawListDirty_ = true;
+    // Bumped on every re-merge; per-frame buffers are rewritten when theirs is older
+    uint64_t drawListVersion_ = 0;
+    // Object indices patched this frame, queued on every frame in flight
+    std::vector<uint32_t> movedObjects_;
     std::unordered_map<std::string, std::shared_ptr<LoadedGLTF>> loadedScenes_;
+    uint32_t meshBufferCount_ = 0;
+
+    // GEOMETRY
+    // Every mesh is suballocated from one vertex & one index buffer.
+    // Capacities are in elements and must be set before init().
+    GeometryArena geometryArena_;
+    uint32_t geometryArenaVertices_ = 2 * 1024 * 1024;
+    uint32_t geometryArenaIndices_  = 8 * 1024 * 1024;
+
+    // CULLING
+    // World-space spheres for drawCtx_, rebuilt on re-merge & patched for moved surfaces. visibleDraws_ holds the
+    // surviving opaque indices, followed by the surviving transparent ones, each frame.
+    bool frustumCulling_ = true;
+    CullingSpheres opaqueSpheres_;
+    CullingSpheres transparentSpheres_;
+    std::vector<uint32_t> visibleDraws_;
+    uint32_t visibleCount_       = 0;
+    uint32_t visibleOpaqueCount_ = 0;
+
+    // DRAW SORTING
+    // Scratch for the radix sort; sized with the draw list so sorting never allocates
+    DrawSortMode drawSortMode_ = DrawSortMode::STATE;
+    std::vector<uint64_t> sortKeys_;
+    std::vector<uint64_t> sortKeysTmp_;
+    std::vector<uint32_t> sortedDraws_;
+    std::vector<uint32_t> sortedDrawsTmp_;
+
+    // INSTANCING
+    // Sorted visible draws collapsed into instanced runs: opaque runs first, then one
+    // run per transparent draw (never merged, to keep their order)
+    bool instancing_ = true;
+    std::vector<InstancedDraw> instancedDraws_;
+    uint32_t instancedDrawCount_   = 0;
+    uint32_t instancedOpaqueCount_ = 0;
+
+    // JOBS
+    // One worker per hardware thread, the main thread included
+    JobSystem jobs_;
+
+    // PARALLEL RECORDING
+    // Opaque draws are split into jobs, each recording one secondary command buffer
+    uint32_t recordThreadCount_ = 1;
+    bool parallelRecording_     = true;
+
+    // GPU-DRIVEN RENDERING
+    // Opaque draws are culled by cull.comp and issued with one indirect draw per batch.
+    // gpuDraws_ follows the merged opaque order: rebuilt on re-merge, spheres patched on moves.
+    bool gpuDrivenRendering_ = true;
+    std::vector<GPUDrawData> gpuDraws_;
+    std::vector<IndirectBatch> indirectBatches_;
+    uint32_t gpuVisibleDraws_     = 0;
+    uint32_t gpuVisibleTriangles_ = 0;
+    VkPipeline cullPipeline_;
+    VkPipelineLayout cullPipelineLayout_;
 
     // CAMERA
     Camera mainCamera_;
 
+    // LATENCY
+    // Frames are presented with increasing present ids when VK_KHR_present_id/present_wait
+    // are supported; otherwise their timeline value stands in for presentation
+    LatencyTracker latency_;
+    bool presentWaitSupported_              = false;
+    PFN_vkWaitForPresentKHR waitForPresent_ = nullptr;
+    uint64_t presentId_                     = 0;
+
+    // BLOCK COMPRESSION
+    // Enabled when supported: BCn textures are then uploaded as is, and fail to load otherwise
+    bool textureCompressionBCSupported_ = false;
+
     struct EngineStats {
         float frameTime;
         int triangleCount;
         int drawCallCount;
         float sceneUpdateTime;
         float meshDrawTime;
+        float submitTime;
+        float presentTime;
+        // CPU blocked on the frame's timeline value
+        float fenceWaitTime = 0.0f;
+        // First to last GPU timestamp, from the last completed frame
+        float gpuFrameTime = 0.0f;
+        // Share of the shorter of CPU & GPU time that ran concurrently with the other (0-1)
+        float cpuGpuOverlap = 0.0f;
+        int visibleCount;
+        int culledCount;
+        int recordThreadCount;
+        // Per job system worker, over the last frame
+        std::vector<JobSystem::WorkerStats> workers;
+        // Upload batches & bytes staged over the last frame
+        UploadManager::Stats uploads{};
+        // GPU time per pass, from the last completed frame
+        float gpuPassTimes[GPU_PASS_COUNT];
     } stats_;
 
+    // GPU TIMESTAMPS
+    bool gpuTimestampsSupported_ = false;
+    float timestampPeriod_       = 1.0f; // ns per tick
+    uint64_t timestampMask_      = ~0ull;
+
     // MSAA
     VkSampleCountFlagBits maxMsaaSamples_      = VK_SAMPLE_COUNT_1_BIT;
     VkSampleCountFlagBits selectedMsaaSamples_ = VK_SAMPLE_COUNT_4_BIT;
@@ -153,39 +404,102 @@ public:
 
     void run();
 
-    GPUMeshBuffers uploadMesh(std::span<uint32_t> indices, std::span<Vertex> vertices) const;
+    void runHeadless(uint32_t frameCount);
+
+    // Pumps SDL events into ImGui & the camera; returns false once the window is closed
+    bool processEvents();
+
+    // Renders a single frame (UI, scene update, draw, present) and updates frame stats
+    void frame();
+
+    // Copies the last rendered frame (drawExtent_) back to the host as RGBA8
+    std::vector<uint8_t> readbackDrawImage();
+
+    // Uploads through uploads_ without waiting; frames submitted afterwards wait for the upload on the GPU
+    GPUMeshBuffers uploadMesh(std::span<const uint32_t> indices, std::span<const Vertex> vertices);
+    // Returns the mesh's range to the geometry arena; the GPU must be done with it
+    void freeMesh(const GPUMeshBuffers &mesh);
 
     // IMAGES
     jvk::Image createImage(VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false, VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT) const;
-    jvk::Image createImage(void *data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false) const;
+    jvk::Image allocateImage(VkExtent3D size, VkFormat format, VkImageUsageFlags usage, uint32_t levelCount, VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT) const;
+    // Uploads without waiting, like uploadMesh(); data is mip 0 in any format of jvk::formatBlock()
+    jvk::Image createImage(void *data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false);
+    // Uploads a prebuilt chain of the first levelCount mips, packed from mip 0 down
+    jvk::Image createImage(const void *data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, uint32_t levelCount);
     void destroyImage(const jvk::Image &image) const;
 
     // BUFFERS
     jvk::Buffer createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage) const;
+    VkDeviceAddress getBufferAddress(VkBuffer buffer) const;
     void destroyBuffer(const jvk::Buffer &buffer) const;
 
     void updateScene();
+
+    // Runs destroy once graphicsTimeline_ reaches value
+    void deferDestroy(uint64_t value, std::function<void()> &&destroy);
+    // Runs destroy once all graphics work submitted so far has finished
+    void deferDestroy(std::function<void()> &&destroy);
+
+    /**
+     * Waits for the GPU, then switches frames in flight (clamped to
+     * [1, JVK_MAX_FRAMES]) and the present mode, recreating the swapchain.
+     * Buffers of frame slots no longer in use are released.
+     */
+    void setFramePacing(const FramePacing &pacing);
+
+    void addScene(const std::string &name, const std::shared_ptr<LoadedGLTF> &scene);
+    void removeScene(const std::string &name);
 private:
     bool resizeRequested_ = false;
     void resizeSwapchain();
 
+    // Changed from the UI, applied between frames
+    bool pacingRequested_ = false;
+    FramePacing requestedPacing_;
+    void releaseFrameBuffers(FrameData &frame) const;
+
+    // Reports frames presented since the last call to latency_
+    void pollPresentation();
+    // Runs the deferred destructions whose timeline value has been reached
+    void collectGarbage();
+
     // INITIALIZATION
     void initVulkan();
     void initSwapchain();
     void initDrawImages();
     void initCommands();
     void initSyncStructures();
+    void initTimestampQueries();
     void initDescriptors();
     void initPipelines();
     void initImgui();
 
     // DRAW
+    void drawUI();
     void drawBackground(VkCommandBuffer cmd) const;
     void drawImgui(VkCommandBuffer cmd, VkImageView targetImageView) const;
     void drawGeometry(VkCommandBuffer r);
+    void setViewportScissor(VkCommandBuffer cmd) const;
+    void cullDraws();
+    void buildIndirectBatches();
+    // Copies the moved RenderObjects of every scene into drawCtx_ & the culling data
+    void patchMovedDraws();
+    void prepareTransforms();
+    void prepareIndirectBuffers();
+    void readIndirectCounts();
+    void dispatchCulling(VkCommandBuffer cmd);
+    void recordIndirectDraws(VkCommandBuffer cmd, int &drawCount);
+    // Fills instancedDraws_ and the frame's instance buffer from the sorted visible draws
+    void buildInstancedDraws();
+    // Records opaque runs [first, last) of instancedDraws_, then (optionally) the transparent ones
+    void recordDraws(VkCommandBuffer cmd, uint32_t first, uint32_t last, bool transparent, int &drawCount, int &triangleCount);
+    void writeTimestamp(VkCommandBuffer cmd, GPUPass pass, bool end);
+    void readTimestamps();
 
     // PIPELINES
     void initBackgroundPipelines();
+    void initCullPipeline();
 
     // MESHES
     void initDefaultData();
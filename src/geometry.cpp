@@ -0,0 +1,85 @@
+#include <geometry.hpp>
+#include <engine.hpp>
+
+void RangeAllocator::init(const uint32_t capacity) {
+    capacity_ = capacity;
+    used_     = 0;
+    freeRanges_.clear();
+    if (capacity > 0) {
+        freeRanges_[0] = capacity;
+    }
+}
+
+uint32_t RangeAllocator::allocate(const uint32_t count) {
+    if (count == 0) return 0;
+
+    for (auto it = freeRanges_.begin(); it != freeRanges_.end(); ++it) {
+        const auto [offset, size] = *it;
+        if (size < count) continue;
+
+        freeRanges_.erase(it);
+        if (size > count) {
+            freeRanges_[offset + count] = size - count;
+        }
+        used_ += count;
+        return offset;
+    }
+    return INVALID;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t count) {
+    if (count == 0) return;
+    used_ -= count;
+
+    // Merge with the following range
+    auto next = freeRanges_.lower_bound(offset);
+    if (next != freeRanges_.end() && next->first == offset + count) {
+        count += next->second;
+        next = freeRanges_.erase(next);
+    }
+
+    // Merge with the preceding range
+    if (next != freeRanges_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += count;
+            return;
+        }
+    }
+
+    freeRanges_[offset] = count;
+}
+
+void GeometryArena::init(JVKEngine *engine, const uint32_t vertexCapacity, const uint32_t indexCapacity) {
+    vertexBuffer        = engine->createBuffer(static_cast<size_t>(vertexCapacity) * sizeof(Vertex), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+    indexBuffer         = engine->createBuffer(static_cast<size_t>(indexCapacity) * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+    vertexBufferAddress = engine->getBufferAddress(vertexBuffer);
+
+    vertices.init(vertexCapacity);
+    indices.init(indexCapacity);
+}
+
+void GeometryArena::destroy(const JVKEngine *engine) const {
+    engine->destroyBuffer(vertexBuffer);
+    engine->destroyBuffer(indexBuffer);
+}
+
+std::optional<GeometryAllocation> GeometryArena::allocate(const uint32_t vertexCount, const uint32_t indexCount) {
+    const uint32_t vertexOffset = vertices.allocate(vertexCount);
+    if (vertexOffset == RangeAllocator::INVALID) {
+        return std::nullopt;
+    }
+
+    const uint32_t firstIndex = indices.allocate(indexCount);
+    if (firstIndex == RangeAllocator::INVALID) {
+        vertices.free(vertexOffset, vertexCount);
+        return std::nullopt;
+    }
+
+    return GeometryAllocation{vertexOffset, vertexCount, firstIndex, indexCount};
+}
+
+void GeometryArena::free(const GeometryAllocation &allocation) {
+    vertices.free(allocation.vertexOffset, allocation.vertexCount);
+    indices.free(allocation.firstIndex, allocation.indexCount);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <jvk.hpp>
+#include <jvk/buffer.hpp>
+
+#include <map>
+
+class JVKEngine;
+
+/**
+ * First-fit free-list allocator over a range of [0, capacity) elements.
+ * Freed ranges are coalesced with their neighbours.
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t INVALID = ~0u;
+
+    void init(uint32_t capacity);
+
+    // Returns the offset of the range, or INVALID if no free range is large enough
+    uint32_t allocate(uint32_t count);
+    void free(uint32_t offset, uint32_t count);
+
+    uint32_t capacity() const { return capacity_; }
+    uint32_t used() const { return used_; }
+
+private:
+    // offset -> size of each free range
+    std::map<uint32_t, uint32_t> freeRanges_;
+    uint32_t capacity_ = 0;
+    uint32_t used_     = 0;
+};
+
+/**
+ * A mesh's slice of the geometry arena, in elements (vertices & indices)
+ */
+struct GeometryAllocation {
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+/**
+ * One vertex buffer (read through its device address) and one index buffer
+ * shared by every mesh. Meshes keep their local indices: draws pass the
+ * allocation's vertexOffset, which gl_VertexIndex includes.
+ */
+struct GeometryArena {
+    jvk::Buffer vertexBuffer;
+    jvk::Buffer indexBuffer;
+    VkDeviceAddress vertexBufferAddress;
+
+    RangeAllocator vertices;
+    RangeAllocator indices;
+
+    void init(JVKEngine *engine, uint32_t vertexCapacity, uint32_t indexCapacity);
+    void destroy(const JVKEngine *engine) const;
+
+    // Returns std::nullopt if either buffer is full
+    std::optional<GeometryAllocation> allocate(uint32_t vertexCount, uint32_t indexCount);
+    void free(const GeometryAllocation &allocation);
+};
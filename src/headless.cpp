@@ -0,0 +1,67 @@
+#include <engine.hpp>
+
+#include <fstream>
+
+/**
+ * Writes RGBA8 pixels as a binary PPM (alpha is dropped)
+ */
+static bool writePPM(const std::string &path, const std::vector<uint8_t> &pixels, const uint32_t width, const uint32_t height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+        file.write(reinterpret_cast<const char *>(&pixels[i * 4]), 3);
+    }
+    return file.good();
+}
+
+// Usage: JVK_Headless [--frames N] [--scene path.glb] [--width W] [--height H] [--out frame.ppm]
+int main(int argc, char **argv) {
+    JVKEngine engine;
+    engine.headless_ = true;
+
+    uint32_t frameCount = 100;
+    std::string outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            fmt::println(stderr, "Missing value for argument: {}", arg);
+            return 1;
+        }
+
+        if (arg == "--frames") {
+            frameCount = std::stoul(argv[++i]);
+        } else if (arg == "--scene") {
+            engine.scenePath_ = argv[++i];
+        } else if (arg == "--width") {
+            engine.windowExtent_.width = std::stoul(argv[++i]);
+        } else if (arg == "--height") {
+            engine.windowExtent_.height = std::stoul(argv[++i]);
+        } else if (arg == "--out") {
+            outPath = argv[++i];
+        } else {
+            fmt::println(stderr, "Unknown argument: {}", arg);
+            return 1;
+        }
+    }
+
+    engine.init();
+    engine.runHeadless(frameCount);
+    fmt::println("Rendered {} frames, last frame {:.3f} ms", frameCount, engine.stats_.frameTime);
+
+    if (!outPath.empty() && frameCount > 0) {
+        const std::vector<uint8_t> pixels = engine.readbackDrawImage();
+        if (writePPM(outPath, pixels, engine.drawExtent_.width, engine.drawExtent_.height)) {
+            fmt::println("Wrote {}", outPath);
+        } else {
+            fmt::println(stderr, "Failed to write {}", outPath);
+        }
+    }
+
+    engine.cleanup();
+    return 0;
+}
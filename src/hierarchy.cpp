@@ -0,0 +1,160 @@
+#include <hierarchy.hpp>
+
+void SceneHierarchy::build(const std::span<const uint32_t> parentOf, const std::span<const glm::mat4> nodeLocalTransforms, const std::span<const uint32_t> nodeMeshIds) {
+    const uint32_t count = static_cast<uint32_t>(parentOf.size());
+
+    // CHILD LISTS
+    // Children of input node p are children[childStart[p], childStart[p + 1])
+    std::vector<uint32_t> childStart(count + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parentOf[i] != INVALID) childStart[parentOf[i] + 1]++;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        childStart[i + 1] += childStart[i];
+    }
+
+    std::vector<uint32_t> children(childStart[count]);
+    std::vector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parentOf[i] != INVALID) children[cursor[parentOf[i]]++] = i;
+    }
+
+    // DEPTH-FIRST PRE-ORDER
+    parents.clear();
+    localTransforms.clear();
+    meshIds.clear();
+    flags.clear();
+    indexToHandle_.clear();
+    handleToIndex_.assign(count, INVALID);
+
+    std::vector<uint32_t> stack;
+    for (uint32_t root = 0; root < count; ++root) {
+        if (parentOf[root] != INVALID) continue;
+
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const uint32_t node = stack.back();
+            stack.pop_back();
+
+            handleToIndex_[node] = size();
+            indexToHandle_.push_back(node);
+            parents.push_back(parentOf[node] == INVALID ? INVALID : handleToIndex_[parentOf[node]]);
+            localTransforms.push_back(nodeLocalTransforms[node]);
+            meshIds.push_back(nodeMeshIds[node]);
+            flags.push_back(nodeMeshIds[node] != INVALID ? NODE_FLAG_HAS_MESH : NODE_FLAG_NONE);
+
+            // Reversed, so the first child is visited first
+            for (uint32_t c = childStart[node + 1]; c > childStart[node]; --c) {
+                stack.push_back(children[c - 1]);
+            }
+        }
+    }
+
+    // SUBTREE SIZES
+    // Children come after their parent, so one reverse pass accumulates them
+    subtreeSizes.assign(size(), 1);
+    for (uint32_t i = size(); i-- > 0;) {
+        if (parents[i] != INVALID) subtreeSizes[parents[i]] += subtreeSizes[i];
+    }
+
+    worldTransforms.resize(size());
+    updateWorldTransforms(0, size());
+    dirty_ = false;
+}
+
+NodeHandle SceneHierarchy::insert(const NodeHandle parent, const glm::mat4 &localTransform, const uint32_t meshId) {
+    const uint32_t parentIndex = parent.valid() ? indexOf(parent) : INVALID;
+    const uint32_t index       = parent.valid() ? parentIndex + subtreeSizes[parentIndex] : size();
+
+    const glm::mat4 world = parent.valid() ? worldTransforms[parentIndex] * localTransform : localTransform;
+    const NodeHandle node{static_cast<uint32_t>(handleToIndex_.size())};
+    handleToIndex_.push_back(index);
+
+    parents.insert(parents.begin() + index, parentIndex);
+    subtreeSizes.insert(subtreeSizes.begin() + index, 1);
+    localTransforms.insert(localTransforms.begin() + index, localTransform);
+    worldTransforms.insert(worldTransforms.begin() + index, world);
+    meshIds.insert(meshIds.begin() + index, meshId);
+    flags.insert(flags.begin() + index, meshId != INVALID ? NODE_FLAG_HAS_MESH : NODE_FLAG_NONE);
+    indexToHandle_.insert(indexToHandle_.begin() + index, node.id);
+
+    // Shift references to nodes moved back by one
+    for (uint32_t i = index + 1; i < size(); ++i) {
+        if (parents[i] != INVALID && parents[i] >= index) parents[i]++;
+    }
+    for (uint32_t p = parentIndex; p != INVALID; p = parents[p]) {
+        subtreeSizes[p]++;
+    }
+    reindexFrom(index + 1);
+
+    return node;
+}
+
+void SceneHierarchy::remove(const NodeHandle node) {
+    const uint32_t index = indexOf(node);
+    const uint32_t count = subtreeSizes[index];
+
+    for (uint32_t p = parents[index]; p != INVALID; p = parents[p]) {
+        subtreeSizes[p] -= count;
+    }
+    for (uint32_t i = index; i < index + count; ++i) {
+        handleToIndex_[indexToHandle_[i]] = INVALID;
+    }
+
+    const auto erase = [&](auto &array) { array.erase(array.begin() + index, array.begin() + index + count); };
+    erase(parents);
+    erase(subtreeSizes);
+    erase(localTransforms);
+    erase(worldTransforms);
+    erase(meshIds);
+    erase(flags);
+    erase(indexToHandle_);
+
+    // Shift references to nodes moved forward; no remaining node had a parent in the removed range
+    for (uint32_t i = index; i < size(); ++i) {
+        if (parents[i] != INVALID && parents[i] > index) parents[i] -= count;
+    }
+    reindexFrom(index);
+}
+
+void SceneHierarchy::setLocalTransform(const NodeHandle node, const glm::mat4 &localTransform) {
+    const uint32_t index   = indexOf(node);
+    localTransforms[index] = localTransform;
+    flags[index] |= NODE_FLAG_DIRTY;
+    dirty_ = true;
+}
+
+void SceneHierarchy::updateDirtyTransforms(std::vector<NodeRange> &updated) {
+    if (!dirty_) return;
+
+    uint32_t i = 0;
+    while (i < size()) {
+        if (!(flags[i] & NODE_FLAG_DIRTY)) {
+            ++i;
+            continue;
+        }
+
+        // The whole subtree follows; skip past it once recomputed
+        const uint32_t count = subtreeSizes[i];
+        updateWorldTransforms(i, count);
+        for (uint32_t j = i; j < i + count; ++j) {
+            flags[j] &= ~NODE_FLAG_DIRTY;
+        }
+        updated.push_back({i, count});
+        i += count;
+    }
+    dirty_ = false;
+}
+
+void SceneHierarchy::updateWorldTransforms(const uint32_t first, const uint32_t count) {
+    for (uint32_t i = first; i < first + count; ++i) {
+        const uint32_t parent = parents[i];
+        worldTransforms[i]    = parent == INVALID ? localTransforms[i] : worldTransforms[parent] * localTransforms[i];
+    }
+}
+
+void SceneHierarchy::reindexFrom(const uint32_t first) {
+    for (uint32_t i = first; i < size(); ++i) {
+        handleToIndex_[indexToHandle_[i]] = i;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <span>
+
+/**
+ * Stable reference to a node of a SceneHierarchy. Survives insertions and
+ * removals of other nodes; invalid once its own node is removed.
+ */
+struct NodeHandle {
+    uint32_t id = ~0u;
+
+    bool valid() const { return id != ~0u; }
+};
+
+enum NodeFlags : uint8_t {
+    NODE_FLAG_NONE     = 0,
+    NODE_FLAG_HAS_MESH = 1 << 0,
+    // Local transform changed since the last updateDirtyTransforms()
+    NODE_FLAG_DIRTY = 1 << 1,
+};
+
+/**
+ * A contiguous range of nodes [first, first + count)
+ */
+struct NodeRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+/**
+ * A transform hierarchy stored as flat, parent-sorted arrays.
+ *
+ * Nodes are kept in depth-first pre-order: a parent always precedes its
+ * children, and the subtree of node i is the contiguous range
+ * [i, i + subtreeSizes[i]). World transforms are propagated with a single
+ * linear pass over such a range.
+ *
+ * Local transform changes are deferred: setLocalTransform() only flags the
+ * node, and updateDirtyTransforms() recomputes every flagged subtree at once.
+ *
+ * Array positions change on insertion and removal; NodeHandles do not.
+ */
+class SceneHierarchy {
+public:
+    static constexpr uint32_t INVALID = ~0u;
+
+    // NODE ARRAYS
+    std::vector<uint32_t> parents;     // INVALID for roots
+    std::vector<uint32_t> subtreeSizes;// Including the node itself
+    std::vector<glm::mat4> localTransforms;
+    std::vector<glm::mat4> worldTransforms;
+    std::vector<uint32_t> meshIds;     // INVALID for nodes without a mesh
+    std::vector<uint8_t> flags;
+
+    uint32_t size() const { return static_cast<uint32_t>(parents.size()); }
+
+    uint32_t indexOf(const NodeHandle node) const { return handleToIndex_[node.id]; }
+    NodeHandle handleOf(const uint32_t index) const { return {indexToHandle_[index]}; }
+    // Whether node is in the hierarchy (not removed, nor dropped by build())
+    bool contains(const NodeHandle node) const { return node.id < handleToIndex_.size() && handleToIndex_[node.id] != INVALID; }
+
+    /**
+     * Replaces the hierarchy with nodes given in any order, each naming its
+     * parent by input position (or INVALID). The handle of input node i has id i.
+     * Nodes not reachable from a root (cycles) are dropped.
+     */
+    void build(std::span<const uint32_t> parentOf, std::span<const glm::mat4> localTransforms, std::span<const uint32_t> meshIds);
+
+    // Adds a node as the last child of parent (or as the last root)
+    NodeHandle insert(NodeHandle parent, const glm::mat4 &localTransform, uint32_t meshId = INVALID);
+    // Removes a node and its subtree
+    void remove(NodeHandle node);
+
+    // Sets a node's local transform and flags it; world transforms are stale until updateDirtyTransforms()
+    void setLocalTransform(NodeHandle node, const glm::mat4 &localTransform);
+    bool dirty() const { return dirty_; }
+
+    /**
+     * Recomputes the world transforms of flagged nodes and their subtrees in one
+     * linear pass, then clears the flags. Each recomputed subtree is appended to
+     * updated; flagged nodes inside an already recomputed subtree add nothing.
+     */
+    void updateDirtyTransforms(std::vector<NodeRange> &updated);
+
+    /**
+     * Recomputes world transforms of [first, first + count). The range must
+     * start at a root or at a node whose parent is already up to date
+     * (e.g. a whole subtree).
+     */
+    void updateWorldTransforms(uint32_t first, uint32_t count);
+
+private:
+    std::vector<uint32_t> handleToIndex_;
+    std::vector<uint32_t> indexToHandle_;
+    bool dirty_ = false;
+
+    void reindexFrom(uint32_t first);
+};
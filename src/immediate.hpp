@@ -3,19 +3,23 @@
 #include "jvk/init.hpp"
 #include <jvk.hpp>
 #include <jvk/commands.hpp>
-#include <jvk/fence.hpp>
+#include <jvk/semaphore.hpp>
 
+/**
+ * Blocking one-off command submissions (e.g. readbacks), tracked on the
+ * timeline semaphore shared with the frames instead of a fence of their own.
+ */
 struct ImmediateBuffer {
-    jvk::Fence fence;
     jvk::CommandPool pool;
     jvk::CommandBuffer cmd;
+    jvk::TimelineSemaphore *timeline = nullptr;
 
     ImmediateBuffer() {};
 
-    VkResult init(VkDevice device, const uint32_t familyIndex, VkCommandPoolCreateFlagBits flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT) {
+    VkResult init(VkDevice device, const uint32_t familyIndex, jvk::TimelineSemaphore *timeline_, VkCommandPoolCreateFlagBits flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT) {
+        timeline = timeline_;
+
         VkResult res;
-        res = fence.init(device);
-        if (res != VK_SUCCESS) { return res; }
         res = pool.init(device, familyIndex, flags);
         if (res != VK_SUCCESS) { return res; }
         return pool.allocateCommandBuffer(&cmd);
@@ -23,12 +27,10 @@ struct ImmediateBuffer {
 
     void destroy() {
         pool.destroy();
-        fence.destroy();
     }
 
+    // Records, submits and waits for completion, so the buffer is free again on return
     void submit(VkQueue queue, std::function<void(VkCommandBuffer cmd)> &&function) const {
-        // Reset fence & buffer
-        VK_CHECK(fence.reset());
         VK_CHECK(cmd.reset());
 
         // Create and start buffer
@@ -40,10 +42,12 @@ struct ImmediateBuffer {
         // End buffer
         VK_CHECK(cmd.end());
 
-        // Submit and wait for fence
+        // Submit, signaling the next timeline value, and wait for it
+        const uint64_t value              = timeline->nextValue();
         VkCommandBufferSubmitInfo cmdInfo = cmd.submitInfo();
-        VkSubmitInfo2 submit              = jvk::init::submit(&cmdInfo, nullptr, nullptr);
-        VK_CHECK(vkQueueSubmit2(queue, 1, &submit, fence));
-        fence.wait();
+        VkSemaphoreSubmitInfo signalInfo  = timeline->submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, value);
+        VkSubmitInfo2 submit              = jvk::init::submit(&cmdInfo, &signalInfo, nullptr);
+        VK_CHECK(vkQueueSubmit2(queue, 1, &submit, VK_NULL_HANDLE));
+        VK_CHECK(timeline->wait(value));
     }
 };
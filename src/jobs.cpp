@@ -0,0 +1,221 @@
+#include <jobs.hpp>
+
+#include <chrono>
+
+struct Job {
+    std::function<void()> task;
+    // Unfinished dependencies, plus one held by schedule() until it has registered them all
+    std::atomic<uint32_t> pendingDependencies{1};
+    std::atomic<bool> finished{false};
+
+    // Guards continuations against a concurrent finish
+    std::mutex mutex;
+    std::vector<JobHandle> continuations;
+};
+
+static thread_local uint32_t tWorkerIndex = 0;
+// Jobs run inside wait() nest; only the outermost one is timed
+static thread_local uint32_t tJobDepth = 0;
+
+uint32_t JobSystem::workerIndex() {
+    return tWorkerIndex;
+}
+
+void JobSystem::init(const uint32_t threadCount) {
+    stop_ = false;
+    queues_.clear();
+    for (uint32_t i = 0; i < threadCount + 1; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    threads_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i + 1); });
+    }
+}
+
+void JobSystem::destroy() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread &thread: threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    queues_.clear();
+}
+
+JobHandle JobSystem::schedule(std::function<void()> task, const std::span<const JobHandle> dependencies) {
+    auto job  = std::make_shared<Job>();
+    job->task = std::move(task);
+
+    for (const JobHandle &dependency: dependencies) {
+        if (!dependency) continue;
+
+        std::lock_guard lock(dependency->mutex);
+        if (!dependency->finished) {
+            job->pendingDependencies++;
+            dependency->continuations.push_back(job);
+        }
+    }
+
+    if (--job->pendingDependencies == 0) {
+        push(job);
+    }
+    return job;
+}
+
+void JobSystem::wait(const JobHandle &job) {
+    if (!job) return;
+
+    const uint32_t index = workerIndex();
+    while (!job->finished) {
+        if (const JobHandle next = pop(index)) {
+            execute(index, next);
+            continue;
+        }
+
+        // Nothing to help with; sleep until new work shows up or the job finishes
+        std::unique_lock lock(sleepMutex_);
+        sleepingCount_++;
+        waitingCount_++;
+        wake_.wait(lock, [&] { return job->finished || queuedCount_ > 0; });
+        sleepingCount_--;
+        waitingCount_--;
+    }
+}
+
+void JobSystem::wait(const std::span<const JobHandle> jobs) {
+    for (const JobHandle &job: jobs) {
+        wait(job);
+    }
+}
+
+void JobSystem::parallelFor(const uint32_t count, const uint32_t minBatch, const std::function<void(uint32_t, uint32_t)> &task) {
+    if (count == 0) return;
+
+    const uint32_t batchCount = std::clamp(count / std::max(minBatch, 1u), 1u, workerCount() * JVK_JOB_BATCHES_PER_WORKER);
+    if (batchCount == 1) {
+        task(0, count);
+        return;
+    }
+
+    std::vector<JobHandle> jobs;
+    jobs.reserve(batchCount);
+    for (uint32_t b = 0; b < batchCount; ++b) {
+        const uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(count) * b / batchCount);
+        const uint32_t last  = static_cast<uint32_t>(static_cast<uint64_t>(count) * (b + 1) / batchCount);
+        jobs.push_back(schedule([&task, first, last] { task(first, last); }));
+    }
+    wait(jobs);
+}
+
+void JobSystem::collectStats(std::vector<WorkerStats> &stats) {
+    stats.resize(workerCount());
+    for (uint32_t i = 0; i < workerCount(); ++i) {
+        WorkerQueue &queue  = *queues_[i];
+        stats[i].busyTime   = static_cast<float>(queue.busyNs.exchange(0)) / 1000000.0f;
+        stats[i].jobCount   = queue.jobCount.exchange(0);
+        stats[i].stealCount = queue.stealCount.exchange(0);
+    }
+}
+
+void JobSystem::workerLoop(const uint32_t index) {
+    tWorkerIndex = index;
+
+    while (true) {
+        if (const JobHandle job = pop(index)) {
+            execute(index, job);
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        sleepingCount_++;
+        wake_.wait(lock, [this] { return stop_ || queuedCount_ > 0; });
+        sleepingCount_--;
+        if (stop_) return;
+    }
+}
+
+void JobSystem::push(JobHandle job) {
+    // Counted before it is visible, so the count never drops below zero
+    queuedCount_++;
+
+    WorkerQueue &queue = *queues_[workerIndex()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    wake(sleepingCount_);
+}
+
+JobHandle JobSystem::pop(const uint32_t index) {
+    if (queuedCount_ == 0) return nullptr;
+
+    // Own jobs, newest first
+    {
+        WorkerQueue &queue = *queues_[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            JobHandle job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            queuedCount_--;
+            return job;
+        }
+    }
+
+    // Steal the oldest job of another worker
+    for (uint32_t i = 1; i < workerCount(); ++i) {
+        WorkerQueue &victim = *queues_[(index + i) % workerCount()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            JobHandle job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedCount_--;
+            queues_[index]->stealCount++;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const uint32_t index, const JobHandle &job) {
+    const auto start = std::chrono::steady_clock::now();
+    tJobDepth++;
+    job->task();
+    job->task = nullptr;
+    tJobDepth--;
+
+    WorkerQueue &queue = *queues_[index];
+    if (tJobDepth == 0) {
+        const auto end = std::chrono::steady_clock::now();
+        queue.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+    queue.jobCount++;
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard lock(job->mutex);
+        job->finished = true;
+        continuations.swap(job->continuations);
+    }
+    for (JobHandle &continuation: continuations) {
+        if (--continuation->pendingDependencies == 0) {
+            push(std::move(continuation));
+        }
+    }
+
+    // Idle workers only care about new jobs
+    wake(waitingCount_);
+}
+
+void JobSystem::wake(const std::atomic<uint32_t> &sleepers) {
+    if (sleepers == 0) return;
+
+    // Taking the lock orders this against a sleeper checking its condition
+    { std::lock_guard lock(sleepMutex_); }
+    wake_.notify_all();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Target number of parallelFor batches per worker, so idle workers have something to steal
+constexpr uint32_t JVK_JOB_BATCHES_PER_WORKER = 4;
+
+struct Job;
+
+/**
+ * Reference to a scheduled job; keeps it alive until released. An empty
+ * handle counts as finished.
+ */
+using JobHandle = std::shared_ptr<Job>;
+
+/**
+ * A work-stealing job system.
+ *
+ * Every worker owns a deque: it pushes and pops its own jobs at the back
+ * (newest first, still warm in cache) and steals from the front of the
+ * others' deques (oldest first, usually the largest pieces of work) when
+ * its own runs dry. The thread that called init() is worker 0 and runs jobs
+ * whenever it waits, so waiting never blocks while work is available.
+ *
+ * Jobs may schedule and wait on further jobs. A job with dependencies is only
+ * queued once all of them have finished.
+ */
+class JobSystem {
+public:
+    struct WorkerStats {
+        float busyTime;// ms spent running jobs
+        uint32_t jobCount;
+        uint32_t stealCount;
+    };
+
+    JobSystem() {};
+    JobSystem(JobSystem const &)            = delete;
+    JobSystem &operator=(JobSystem const &) = delete;
+
+    // Spawns threadCount background workers next to the calling thread
+    void init(uint32_t threadCount);
+    void destroy();
+
+    // Number of workers, including the calling thread
+    uint32_t workerCount() const { return static_cast<uint32_t>(queues_.size()); }
+    // Index of the current thread's worker; 0 for threads outside the system
+    static uint32_t workerIndex();
+
+    JobHandle schedule(std::function<void()> task, std::span<const JobHandle> dependencies = {});
+    // Runs jobs until the given ones have finished
+    void wait(const JobHandle &job);
+    void wait(std::span<const JobHandle> jobs);
+
+    /**
+     * Calls task(first, last) over batches covering [0, count), each of at
+     * least minBatch items (except the last), and returns once all are done.
+     */
+    void parallelFor(uint32_t count, uint32_t minBatch, const std::function<void(uint32_t, uint32_t)> &task);
+
+    /**
+     * Fills stats (one entry per worker) with the activity since the last
+     * call, then resets the counters.
+     */
+    void collectStats(std::vector<WorkerStats> &stats);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+
+        std::atomic<uint64_t> busyNs{0};
+        std::atomic<uint32_t> jobCount{0};
+        std::atomic<uint32_t> stealCount{0};
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Idle workers & waiters sleep here until a job is queued or one they wait on finishes
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<uint32_t> queuedCount_{0};
+    std::atomic<uint32_t> sleepingCount_{0};
+    std::atomic<uint32_t> waitingCount_{0};// Sleepers inside wait()
+    bool stop_ = false;
+
+    void workerLoop(uint32_t index);
+    void push(JobHandle job);
+    JobHandle pop(uint32_t index);
+    void execute(uint32_t index, const JobHandle &job);
+    void wake(const std::atomic<uint32_t> &sleepers);
+};
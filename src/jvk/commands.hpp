@@ -12,11 +12,12 @@ struct CommandBuffer {
 
     operator VkCommandBuffer() const { return cmd; }
 
-    VkResult begin(VkCommandBufferUsageFlags flags = 0) const {
+    // Secondary command buffers must pass inheritance info
+    VkResult begin(VkCommandBufferUsageFlags flags = 0, const VkCommandBufferInheritanceInfo *inheritance = nullptr) const {
         VkCommandBufferBeginInfo info = {};
         info.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         info.pNext                    = nullptr;
-        info.pInheritanceInfo         = nullptr;
+        info.pInheritanceInfo         = inheritance;
         info.flags                    = flags;
         return vkBeginCommandBuffer(cmd, &info);
     }
@@ -84,6 +85,11 @@ struct CommandPool {
 
     operator VkCommandPool() const { return pool; }
 
+    // Resets every command buffer allocated from the pool
+    VkResult reset(VkCommandPoolResetFlags flags = 0) const {
+        return vkResetCommandPool(device, pool, flags);
+    }
+
     void destroy() {
         vkDestroyCommandPool(device, pool, nullptr);
     }
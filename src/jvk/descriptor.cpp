@@ -2,10 +2,10 @@
 
 namespace jvk {
 
-void DescriptorLayoutBuilder::addBinding(uint32_t binding, VkDescriptorType type) {
+void DescriptorLayoutBuilder::addBinding(uint32_t binding, VkDescriptorType type, uint32_t count) {
     VkDescriptorSetLayoutBinding newBinding{};
     newBinding.binding         = binding;
-    newBinding.descriptorCount = 1;
+    newBinding.descriptorCount = count;
     newBinding.descriptorType  = type;
     bindings.push_back(newBinding);
 }
@@ -165,7 +165,7 @@ VkDescriptorSet DynamicDescriptorAllocator::allocate(VkDevice device, VkDescript
     return ds;
 }
 
-void DescriptorWriter::writeImage(int binding, VkImageView image, VkSampler sampler, VkImageLayout layout, VkDescriptorType type) {
+void DescriptorWriter::writeImage(int binding, VkImageView image, VkSampler sampler, VkImageLayout layout, VkDescriptorType type, uint32_t arrayElement) {
     VkDescriptorImageInfo &info = images.emplace_back(VkDescriptorImageInfo{
             .sampler     = sampler,
             .imageView   = image,
@@ -174,6 +174,7 @@ void DescriptorWriter::writeImage(int binding, VkImageView image, VkSampler samp
     VkWriteDescriptorSet write{};
     write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     write.dstBinding      = binding;
+    write.dstArrayElement = arrayElement;
     write.dstSet          = VK_NULL_HANDLE;
     write.descriptorCount = 1;
     write.descriptorType  = type;
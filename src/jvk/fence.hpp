@@ -28,6 +28,11 @@ struct Fence {
         return vkWaitForFences(device, 1, &fence, VK_TRUE, timeout);
     }
 
+    // VK_SUCCESS once signaled, VK_NOT_READY before
+    VkResult status() const {
+        return vkGetFenceStatus(device, fence);
+    }
+
     void destroy() {
         vkDestroyFence(device, fence, nullptr);
     }
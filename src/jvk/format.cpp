@@ -0,0 +1,52 @@
+#include <jvk/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+uint32_t jvk::mipLevelCount(const VkExtent2D imageSize) {
+    return static_cast<uint32_t>(std::floor(std::log2(std::max(imageSize.width, imageSize.height)))) + 1;
+}
+
+jvk::FormatBlock jvk::formatBlock(const VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return {1, 1, 4};
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return {4, 4, 8};
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return {4, 4, 16};
+        default:
+            return {0, 0, 0};
+    }
+}
+
+VkDeviceSize jvk::mipLevelSize(const VkFormat format, const VkExtent3D imageSize, const uint32_t level) {
+    const FormatBlock block = formatBlock(format);
+    assert(block.size != 0);
+
+    // Partial blocks at the edges are stored whole
+    const VkDeviceSize width  = (std::max(imageSize.width >> level, 1u) + block.width - 1) / block.width;
+    const VkDeviceSize height = (std::max(imageSize.height >> level, 1u) + block.height - 1) / block.height;
+    const VkDeviceSize depth  = std::max(imageSize.depth >> level, 1u);
+    return width * height * depth * block.size;
+}
+
+VkDeviceSize jvk::mipChainSize(const VkFormat format, const VkExtent3D imageSize, const uint32_t levelCount) {
+    VkDeviceSize size = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        size += mipLevelSize(format, imageSize, level);
+    }
+    return size;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <jvk.hpp>
+
+namespace jvk {
+
+struct QueryPool {
+    VkQueryPool pool;
+    VkDevice device;
+    uint32_t count;
+
+    QueryPool() {};
+
+    VkResult init(VkDevice device_, VkQueryType type, uint32_t count_) {
+        device = device_;
+        count  = count_;
+
+        VkQueryPoolCreateInfo info = {};
+        info.sType                 = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.pNext                 = nullptr;
+        info.queryType             = type;
+        info.queryCount            = count_;
+        return vkCreateQueryPool(device_, &info, nullptr, &pool);
+    }
+
+    operator VkQueryPool() const { return pool; }
+
+    // Must be recorded outside of a render pass, before any query is written
+    void reset(VkCommandBuffer cmd) const {
+        vkCmdResetQueryPool(cmd, pool, 0, count);
+    }
+
+    void writeTimestamp(VkCommandBuffer cmd, VkPipelineStageFlags2 stage, uint32_t query) const {
+        vkCmdWriteTimestamp2(cmd, stage, pool, query);
+    }
+
+    // Non-blocking read of 64-bit results; with VK_QUERY_RESULT_WITH_AVAILABILITY_BIT each
+    // query occupies two values (result, availability)
+    VkResult getResults(uint64_t *results, VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) const {
+        const size_t stride = (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) ? 2 * sizeof(uint64_t) : sizeof(uint64_t);
+        return vkGetQueryPoolResults(device, pool, 0, count, stride * count, results, stride, flags | VK_QUERY_RESULT_64_BIT);
+    }
+
+    void destroy() {
+        vkDestroyQueryPool(device, pool, nullptr);
+    }
+};
+
+}// namespace jvk
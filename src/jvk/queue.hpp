@@ -13,13 +13,21 @@ struct Queue {
     operator VkQueue() const { return queue; }
 
     VkResult submit(VkCommandBufferSubmitInfo *cmdInfo, VkSemaphoreSubmitInfo *waitSemaphoreInfo, VkSemaphoreSubmitInfo *signalSemaphoreInfo, VkFence fence) const {
+        return submit(cmdInfo,
+                      {waitSemaphoreInfo, waitSemaphoreInfo == nullptr ? 0u : 1u},
+                      {signalSemaphoreInfo, signalSemaphoreInfo == nullptr ? 0u : 1u},
+                      fence);
+    }
+
+    // Any number of wait & signal semaphores (e.g. a binary one for present plus a timeline value)
+    VkResult submit(VkCommandBufferSubmitInfo *cmdInfo, std::span<const VkSemaphoreSubmitInfo> waitSemaphoreInfos, std::span<const VkSemaphoreSubmitInfo> signalSemaphoreInfos, VkFence fence = VK_NULL_HANDLE) const {
         VkSubmitInfo2 info            = {};
         info.sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
         info.pNext                    = nullptr;
-        info.waitSemaphoreInfoCount   = waitSemaphoreInfo == nullptr ? 0 : 1;
-        info.pWaitSemaphoreInfos      = waitSemaphoreInfo;
-        info.signalSemaphoreInfoCount = signalSemaphoreInfo == nullptr ? 0 : 1;
-        info.pSignalSemaphoreInfos    = signalSemaphoreInfo;
+        info.waitSemaphoreInfoCount   = static_cast<uint32_t>(waitSemaphoreInfos.size());
+        info.pWaitSemaphoreInfos      = waitSemaphoreInfos.data();
+        info.signalSemaphoreInfoCount = static_cast<uint32_t>(signalSemaphoreInfos.size());
+        info.pSignalSemaphoreInfos    = signalSemaphoreInfos.data();
         info.commandBufferInfoCount   = 1;
         info.pCommandBufferInfos      = cmdInfo;
         return vkQueueSubmit2(queue, 1, &info, fence);
@@ -37,4 +37,73 @@ struct Semaphore {
     }
 };
 
+/**
+ * A 64-bit counter advanced by the GPU. Every submission signals a fresh
+ * value from nextValue(), so whether submission N has finished is a single
+ * comparison against value(), with no fence per submission.
+ *
+ * nextValue() is not thread-safe; values must be submitted in the order they
+ * were handed out.
+ */
+struct TimelineSemaphore {
+    VkSemaphore semaphore;
+    VkDevice device;
+    // Highest value handed out so far
+    uint64_t submitted = 0;
+
+    TimelineSemaphore() {};
+
+    VkResult init(VkDevice device_, const uint64_t initialValue = 0) {
+        device    = device_;
+        submitted = initialValue;
+
+        VkSemaphoreTypeCreateInfo typeInfo = {};
+        typeInfo.sType                     = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType             = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue              = initialValue;
+
+        VkSemaphoreCreateInfo info = {};
+        info.sType                 = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        info.pNext                 = &typeInfo;
+        return vkCreateSemaphore(device_, &info, nullptr, &semaphore);
+    }
+
+    operator VkSemaphore() const { return semaphore; }
+
+    uint64_t nextValue() { return ++submitted; }
+
+    // The last value the GPU signaled
+    uint64_t value() const {
+        uint64_t current = 0;
+        VK_CHECK(vkGetSemaphoreCounterValue(device, semaphore, &current));
+        return current;
+    }
+
+    bool isComplete(const uint64_t target) const { return value() >= target; }
+
+    VkResult wait(const uint64_t target, const uint64_t timeout = JVK_TIMEOUT) const {
+        VkSemaphoreWaitInfo info = {};
+        info.sType               = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        info.semaphoreCount      = 1;
+        info.pSemaphores         = &semaphore;
+        info.pValues             = &target;
+        return vkWaitSemaphores(device, &info, timeout);
+    }
+
+    VkSemaphoreSubmitInfo submitInfo(VkPipelineStageFlags2 stageMask, const uint64_t target) const {
+        VkSemaphoreSubmitInfo info = {};
+        info.sType                 = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        info.pNext                 = nullptr;
+        info.semaphore             = semaphore;
+        info.stageMask             = stageMask;
+        info.deviceIndex           = 0;
+        info.value                 = target;
+        return info;
+    }
+
+    void destroy() {
+        vkDestroySemaphore(device, semaphore, nullptr);
+    }
+};
+
 }
\ No newline at end of file
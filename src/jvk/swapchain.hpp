@@ -14,6 +14,8 @@ struct Swapchain {
     std::vector<VkImage> images;
     std::vector<VkImageView> imageViews;
     VkExtent2D extent;
+    // May differ from the requested mode; FIFO is the fallback
+    VkPresentModeKHR presentMode;
 
     Swapchain() {};
 
@@ -42,6 +44,7 @@ struct Swapchain {
         images      = vkbSwapchain.get_images().value();
         imageViews  = vkbSwapchain.get_image_views().value();
         extent      = vkbSwapchain.extent;
+        presentMode = vkbSwapchain.present_mode;
     }
 
     void destroy(const Context &context) {
@@ -42,6 +42,23 @@ void jvk::transitionImage(VkCommandBuffer cmd, VkImage image, VkImageLayout oldL
     vkCmdPipelineBarrier2(cmd, &depInfo);
 }
 
+void jvk::memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) {
+    VkMemoryBarrier2 barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    barrier.pNext = nullptr;
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+
+    VkDependencyInfo depInfo = {};
+    depInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    depInfo.pNext = nullptr;
+    depInfo.memoryBarrierCount = 1;
+    depInfo.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &depInfo);
+}
+
 void jvk::copyImageToImage(VkCommandBuffer cmd, VkImage src, VkImage dst, VkExtent2D srcSize, VkExtent2D dstSize) {
     // Bit-block Transfer: copying data from one location to another
     // This is slower than `vkCmdCopyImage` but is more flexible
@@ -82,7 +99,7 @@ void jvk::copyImageToImage(VkCommandBuffer cmd, VkImage src, VkImage dst, VkExte
 }
 
 void jvk::generateMipmaps(VkCommandBuffer cmd, VkImage image, VkExtent2D imageSize) {
-    const int mipLevels = static_cast<int>(std::floor(std::log2(std::max(imageSize.width, imageSize.height)))) + 1;
+    const int mipLevels = static_cast<int>(mipLevelCount(imageSize));
     for (int mip = 0; mip < mipLevels; ++mip) {
         VkExtent2D halfSize = imageSize;
         halfSize.width /= 2;
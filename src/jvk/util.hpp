@@ -6,8 +6,35 @@ namespace jvk {
 
 void transitionImage(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout);
 
+// Global memory barrier, e.g. between a compute pass and the indirect draws consuming its output
+void memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess);
+
 void copyImageToImage(VkCommandBuffer cmd, VkImage src, VkImage dst, VkExtent2D srcSize, VkExtent2D dstSize);
 
 void generateMipmaps(VkCommandBuffer cmd, VkImage image, VkExtent2D imageSize);
 
+// Texture layout helpers below are defined in format.cpp, which needs no device
+
+// Levels of a full mip chain, down to 1x1
+uint32_t mipLevelCount(VkExtent2D imageSize);
+
+// Texels are stored in blocks of width x height texels, size bytes each (1x1 for uncompressed formats)
+struct FormatBlock {
+    uint32_t width;
+    uint32_t height;
+    uint32_t size;
+};
+
+// Block layout of the RGBA8 & BCn formats textures may use; size is 0 for any other format
+FormatBlock formatBlock(VkFormat format);
+
+// Bytes of one mip level, and of the first levelCount levels packed back to back
+VkDeviceSize mipLevelSize(VkFormat format, VkExtent3D imageSize, uint32_t level);
+VkDeviceSize mipChainSize(VkFormat format, VkExtent3D imageSize, uint32_t levelCount);
+
+// Rounds value up to a multiple of alignment
+inline uint64_t alignUp(const uint64_t value, const uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
 }
\ No newline at end of file
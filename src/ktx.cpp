@@ -0,0 +1,268 @@
+#include <ktx.hpp>
+
+#include <jvk/util.hpp>
+
+#include <cstring>
+#include <fstream>
+
+constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+namespace {
+
+struct KTX2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(KTX2Header) == 80, "KTX2Header must match the file layout");
+
+struct KTX2Level {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+}// namespace
+
+bool isKTX2(const std::span<const uint8_t> bytes) {
+    return bytes.size() >= sizeof(KTX2_IDENTIFIER) && memcmp(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+}
+
+std::optional<KTX2Texture> loadKTX2(const std::span<const uint8_t> bytes) {
+    // HEADER
+    KTX2Header header;
+    if (!isKTX2(bytes) || bytes.size() < sizeof(header)) {
+        fmt::println("KTX2: not a KTX2 file");
+        return {};
+    }
+    memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.supercompressionScheme != 0) {
+        fmt::println("KTX2: supercompression scheme {} is not supported (BasisLZ & Zstandard need a transcoder)", header.supercompressionScheme);
+        return {};
+    }
+    const VkFormat format = static_cast<VkFormat>(header.vkFormat);
+    if (jvk::formatBlock(format).size == 0) {
+        // VK_FORMAT_UNDEFINED: UASTC, which also needs a transcoder
+        fmt::println("KTX2: format {} is not supported", string_VkFormat(format));
+        return {};
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1) {
+        fmt::println("KTX2: only 2D textures are supported");
+        return {};
+    }
+
+    KTX2Texture texture{};
+    texture.format     = format;
+    texture.extent     = {header.pixelWidth, header.pixelHeight, 1};
+    // 0 asks the loader to generate mips; only the base level is stored
+    texture.levelCount = std::max(header.levelCount, 1u);
+    if (texture.levelCount > jvk::mipLevelCount({texture.extent.width, texture.extent.height})) {
+        fmt::println("KTX2: too many mip levels");
+        return {};
+    }
+
+    // LEVELS
+    // The index lists mip 0 first; the data is stored smallest mip first
+    if (bytes.size() < sizeof(header) + texture.levelCount * sizeof(KTX2Level)) {
+        fmt::println("KTX2: truncated level index");
+        return {};
+    }
+    texture.levels.resize(jvk::mipChainSize(format, texture.extent, texture.levelCount));
+
+    VkDeviceSize dstOffset = 0;
+    for (uint32_t level = 0; level < texture.levelCount; ++level) {
+        KTX2Level index;
+        memcpy(&index, bytes.data() + sizeof(header) + level * sizeof(KTX2Level), sizeof(index));
+
+        const VkDeviceSize levelSize = jvk::mipLevelSize(format, texture.extent, level);
+        if (index.byteLength != levelSize || index.byteOffset > bytes.size() || index.byteLength > bytes.size() - index.byteOffset) {
+            fmt::println("KTX2: level {} is truncated or of the wrong size", level);
+            return {};
+        }
+
+        memcpy(texture.levels.data() + dstOffset, bytes.data() + index.byteOffset, levelSize);
+        dstOffset += levelSize;
+    }
+    return texture;
+}
+
+// DATA FORMAT DESCRIPTOR
+// KHR_DF color models & channel ids of the formats written
+constexpr uint32_t KHR_DF_MODEL_RGBSDA  = 1;
+constexpr uint32_t KHR_DF_MODEL_BC1A    = 128;
+constexpr uint32_t KHR_DF_MODEL_BC3     = 130;
+constexpr uint32_t KHR_DF_MODEL_BC4     = 131;
+constexpr uint32_t KHR_DF_MODEL_BC5     = 132;
+constexpr uint32_t KHR_DF_MODEL_BC7     = 134;
+constexpr uint32_t KHR_DF_CHANNEL_ALPHA = 15;
+// Qualifier of the channel type byte; alpha is linear in sRGB formats
+constexpr uint32_t KHR_DF_SAMPLE_LINEAR = 0x10;
+
+namespace {
+
+struct DFDSample {
+    uint32_t bitOffset;
+    uint32_t bitLength;
+    uint32_t channel;
+    uint32_t upper;
+};
+
+// Basic descriptor block of format; empty if it has none here
+std::vector<uint32_t> dataFormatDescriptor(const VkFormat format) {
+    uint32_t model;
+    bool srgb = false;
+    std::vector<DFDSample> samples;
+    switch (format) {
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            srgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            model   = KHR_DF_MODEL_RGBSDA;
+            samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, KHR_DF_CHANNEL_ALPHA, 255}};
+            break;
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            srgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            model   = KHR_DF_MODEL_BC1A;
+            samples = {{0, 64, 0, ~0u}};
+            break;
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            srgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            // Channel 1: punch-through alpha
+            model   = KHR_DF_MODEL_BC1A;
+            samples = {{0, 64, 1, ~0u}};
+            break;
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            srgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+            model   = KHR_DF_MODEL_BC3;
+            samples = {{0, 64, KHR_DF_CHANNEL_ALPHA, ~0u}, {64, 64, 0, ~0u}};
+            break;
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            model   = KHR_DF_MODEL_BC4;
+            samples = {{0, 64, 0, ~0u}};
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            model   = KHR_DF_MODEL_BC5;
+            samples = {{0, 64, 0, ~0u}, {64, 64, 1, ~0u}};
+            break;
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            srgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+            model   = KHR_DF_MODEL_BC7;
+            samples = {{0, 128, 0, ~0u}};
+            break;
+        default:
+            return {};
+    }
+
+    const jvk::FormatBlock block = jvk::formatBlock(format);
+    const uint32_t blockSize     = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+    std::vector<uint32_t> dfd;
+    dfd.push_back(4 + blockSize);// Total size
+    dfd.push_back(0);            // Vendor: Khronos, type: basic
+    dfd.push_back(2 | blockSize << 16);
+    // BT.709 primaries, sRGB or linear transfer, straight alpha
+    dfd.push_back(model | 1 << 8 | (srgb ? 2 : 1) << 16);
+    dfd.push_back((block.width - 1) | (block.height - 1) << 8);
+    dfd.push_back(block.size);
+    dfd.push_back(0);
+    for (const DFDSample &sample: samples) {
+        const uint32_t qualifiers = srgb && sample.channel == KHR_DF_CHANNEL_ALPHA ? KHR_DF_SAMPLE_LINEAR : 0;
+        dfd.push_back(sample.bitOffset | (sample.bitLength - 1) << 16 | (sample.channel | qualifiers) << 24);
+        dfd.push_back(0);// Sample position
+        dfd.push_back(0);// Lower
+        dfd.push_back(sample.upper);
+    }
+    return dfd;
+}
+
+}// namespace
+
+bool writeKTX2(const std::filesystem::path &path, const KTX2Texture &texture) {
+    const std::vector<uint32_t> dfd = dataFormatDescriptor(texture.format);
+    if (dfd.empty()) {
+        fmt::println("KTX2: cannot write format {}", string_VkFormat(texture.format));
+        return false;
+    }
+
+    // KEY/VALUE DATA
+    // One entry: its length, then the key & value, both null-terminated, padded to 4 bytes
+    constexpr char WRITER[]     = "KTXwriter\0JVK";
+    const uint32_t writerLength = sizeof(WRITER);
+    const uint32_t kvdLength    = (4 + writerLength + 3) / 4 * 4;
+
+    // LAYOUT
+    // Header, level index, DFD & key/value data, then levels smallest first, each aligned to
+    // the block size (and 4)
+    const uint32_t blockSize   = jvk::formatBlock(texture.format).size;
+    const uint64_t alignment   = std::max(blockSize, 4u);
+    const uint32_t indexOffset = sizeof(KTX2Header);
+    const uint32_t dfdOffset   = indexOffset + texture.levelCount * sizeof(KTX2Level);
+    const uint32_t dfdLength   = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+    const uint32_t kvdOffset   = dfdOffset + dfdLength;
+
+    std::vector<KTX2Level> index(texture.levelCount);
+    uint64_t fileSize = kvdOffset + kvdLength;
+    for (uint32_t level = texture.levelCount; level-- > 0;) {
+        fileSize                            = (fileSize + alignment - 1) / alignment * alignment;
+        index[level].byteOffset             = fileSize;
+        index[level].byteLength             = jvk::mipLevelSize(texture.format, texture.extent, level);
+        index[level].uncompressedByteLength = index[level].byteLength;
+        fileSize += index[level].byteLength;
+    }
+
+    KTX2Header header{};
+    memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat      = texture.format;
+    header.typeSize      = 1;
+    header.pixelWidth    = texture.extent.width;
+    header.pixelHeight   = texture.extent.height;
+    header.faceCount     = 1;
+    header.levelCount    = texture.levelCount;
+    header.dfdByteOffset = dfdOffset;
+    header.dfdByteLength = dfdLength;
+    header.kvdByteOffset = kvdOffset;
+    header.kvdByteLength = kvdLength;
+
+    std::vector<uint8_t> bytes(fileSize);
+    memcpy(bytes.data(), &header, sizeof(header));
+    memcpy(bytes.data() + indexOffset, index.data(), index.size() * sizeof(KTX2Level));
+    memcpy(bytes.data() + dfdOffset, dfd.data(), dfdLength);
+    memcpy(bytes.data() + kvdOffset, &writerLength, 4);
+    memcpy(bytes.data() + kvdOffset + 4, WRITER, writerLength);
+
+    VkDeviceSize srcOffset = 0;
+    for (uint32_t level = 0; level < texture.levelCount; ++level) {
+        memcpy(bytes.data() + index[level].byteOffset, texture.levels.data() + srcOffset, index[level].byteLength);
+        srcOffset += index[level].byteLength;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        fmt::println("KTX2: failed to write {}", path.string());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <filesystem>
+
+/**
+ * A texture read from a KTX2 container: its first levelCount mips, packed
+ * from mip 0 down
+ */
+struct KTX2Texture {
+    VkFormat format;
+    VkExtent3D extent;
+    uint32_t levelCount;
+    std::vector<uint8_t> levels;
+};
+
+// Whether bytes start with the KTX2 identifier
+bool isKTX2(std::span<const uint8_t> bytes);
+
+/**
+ * Reads a 2D KTX2 texture stored in a format of jvk::formatBlock() (RGBA8 or
+ * BCn) without supercompression. Anything else, including Basis Universal
+ * (BasisLZ/ETC1S & UASTC) payloads, which need a transcoder, is rejected
+ * with a message.
+ */
+std::optional<KTX2Texture> loadKTX2(std::span<const uint8_t> bytes);
+
+/**
+ * Writes a texture in a format of jvk::formatBlock() (UNORM or SRGB) as a
+ * KTX2 file without supercompression, with a basic data format descriptor.
+ * Returns false, with a message, if it cannot.
+ */
+bool writeKTX2(const std::filesystem::path &path, const KTX2Texture &texture);
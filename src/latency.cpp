@@ -0,0 +1,82 @@
+#include <latency.hpp>
+
+#include <algorithm>
+
+static float millisecondsBetween(const LatencyClock::time_point from, const LatencyClock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count() / 1000.0f;
+}
+
+void LatencyTracker::markInput(const LatencyClock::time_point time) {
+    if (!pendingInput_ || time < *pendingInput_) {
+        pendingInput_ = time;
+    }
+}
+
+void LatencyTracker::markSimulationStart() {
+    // A frame abandoned before submit hands its input to the next one
+    if (recording_ && current_.input) {
+        markInput(*current_.input);
+    }
+
+    current_.input           = pendingInput_;
+    current_.simulationStart = LatencyClock::now();
+    pendingInput_.reset();
+    recording_ = true;
+}
+
+void LatencyTracker::markSubmit(const uint64_t presentId, const uint64_t timelineValue) {
+    if (!recording_) return;
+
+    current_.frame  = {presentId, timelineValue};
+    current_.submit = LatencyClock::now();
+    pending_.push_back(current_);
+    recording_ = false;
+}
+
+void LatencyTracker::poll(const std::function<bool(const PendingFrame &)> &isPresented) {
+    while (!pending_.empty() && isPresented(pending_.front().frame)) {
+        const Record &record = pending_.front();
+        const auto presented = LatencyClock::now();
+
+        if (record.input) {
+            inputLatency_.add(millisecondsBetween(*record.input, presented));
+        }
+        simulationLatency_.add(millisecondsBetween(record.simulationStart, presented));
+        submitLatency_.add(millisecondsBetween(record.submit, presented));
+
+        pending_.pop_front();
+    }
+}
+
+void LatencyTracker::dropPending() {
+    pending_.clear();
+}
+
+void LatencyTracker::percentiles(LatencyPercentiles &input, LatencyPercentiles &simulation, LatencyPercentiles &submit) const {
+    input      = inputLatency_.percentiles();
+    simulation = simulationLatency_.percentiles();
+    submit     = submitLatency_.percentiles();
+}
+
+void LatencyWindow::add(const float value) {
+    if (samples.size() < JVK_LATENCY_WINDOW) {
+        samples.push_back(value);
+    } else {
+        samples[cursor] = value;
+    }
+    cursor = (cursor + 1) % JVK_LATENCY_WINDOW;
+}
+
+LatencyPercentiles LatencyWindow::percentiles() const {
+    LatencyPercentiles result;
+    if (samples.empty()) return result;
+
+    std::vector<float> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const auto percentile = [&](const float p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+    result.p50 = percentile(0.5f);
+    result.p95 = percentile(0.95f);
+    result.p99 = percentile(0.99f);
+    result.max = sorted.back();
+    return result;
+}
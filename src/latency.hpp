@@ -0,0 +1,80 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <chrono>
+
+using LatencyClock = std::chrono::steady_clock;
+
+// Presented frames the latency percentiles are computed over
+constexpr uint32_t JVK_LATENCY_WINDOW = 256;
+
+struct LatencyPercentiles {
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+/**
+ * The last JVK_LATENCY_WINDOW samples, in ms
+ */
+struct LatencyWindow {
+    std::vector<float> samples;
+    uint32_t cursor = 0;
+
+    void add(float value);
+    LatencyPercentiles percentiles() const;
+};
+
+/**
+ * Follows frames from input to presentation.
+ *
+ * A frame is stamped when its simulation starts (claiming the earliest input
+ * received since the previous frame) and when it is submitted, then stays
+ * pending until poll() sees it presented. Frames are presented in submission
+ * order, so only the oldest pending frame is ever checked.
+ *
+ * Presentation is observed, not signaled: the stamp is the time of the first
+ * poll() that sees the frame presented, so it is only as precise as polls are
+ * frequent.
+ */
+class LatencyTracker {
+public:
+    // How a pending frame is identified to the presentation check
+    struct PendingFrame {
+        uint64_t presentId;
+        uint64_t timelineValue;
+    };
+
+    // Keeps the earliest input until a frame claims it
+    void markInput(LatencyClock::time_point time);
+    void markSimulationStart();
+    void markSubmit(uint64_t presentId, uint64_t timelineValue);
+
+    // Completes pending frames, oldest first, for as long as isPresented returns true
+    void poll(const std::function<bool(const PendingFrame &)> &isPresented);
+    // Forgets pending frames that will never be reported (e.g. swapchain recreated)
+    void dropPending();
+
+    // Sorts a copy of each window, so only call it when the numbers are read
+    void percentiles(LatencyPercentiles &input, LatencyPercentiles &simulation, LatencyPercentiles &submit) const;
+
+private:
+    struct Record {
+        PendingFrame frame;
+        std::optional<LatencyClock::time_point> input;
+        LatencyClock::time_point simulationStart;
+        LatencyClock::time_point submit;
+    };
+
+    std::optional<LatencyClock::time_point> pendingInput_;
+    Record current_;
+    bool recording_ = false;
+    std::deque<Record> pending_;
+
+    // Only frames that claimed an input contribute to inputLatency_
+    LatencyWindow inputLatency_;
+    LatencyWindow simulationLatency_;
+    LatencyWindow submitLatency_;
+};
@@ -14,6 +14,10 @@ void GLTFMetallicRoughness::buildPipelines(JVKEngine *engine) {
     if (!jvk::loadShaderModule("../shaders/mesh.frag.spv", engine->ctx_.device, &fragShader)) {
         fmt::print("Error when building fragment shader module");
     }
+    VkShaderModule indirectVertShader;
+    if (!jvk::loadShaderModule("../shaders/mesh_indirect.vert.spv", engine->ctx_.device, &indirectVertShader)) {
+        fmt::print("Error when building indirect vertex shader module");
+    }
 
     // PUSH CONSTANTS
     VkPushConstantRange matrixRange{};
@@ -21,14 +25,9 @@ void GLTFMetallicRoughness::buildPipelines(JVKEngine *engine) {
     matrixRange.size       = sizeof(GPUDrawPushConstants);
     matrixRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    // DESCRIPTOR LAYOUT
-    jvk::DescriptorLayoutBuilder builder;
-    builder.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-    builder.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-    builder.addBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-    materialDescriptorLayout = builder.build(engine->ctx_.device, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+    // DESCRIPTOR LAYOUTS
     // _gpuSceneDataDescriptorLayout is used as our global descriptor layout
-    VkDescriptorSetLayout layouts[] = {engine->sceneDataDescriptorLayout_, materialDescriptorLayout};
+    VkDescriptorSetLayout layouts[] = {engine->sceneDataDescriptorLayout_, engine->bindless_.layout};
 
     // PIPELINE LAYOUT
     VkPipelineLayoutCreateInfo layoutInfo = jvk::init::pipelineLayout();
@@ -42,6 +41,10 @@ void GLTFMetallicRoughness::buildPipelines(JVKEngine *engine) {
 
     opaquePipeline.pipelineLayout      = layout;
     transparentPipeline.pipelineLayout = layout;
+    indirectPipeline.pipelineLayout    = layout;
+    opaquePipeline.id                  = 0;
+    transparentPipeline.id             = 1;
+    indirectPipeline.id                = 2;
 
     // PIPELINE
     jvk::PipelineBuilder pipelineBuilder;
@@ -65,16 +68,21 @@ void GLTFMetallicRoughness::buildPipelines(JVKEngine *engine) {
 
     opaquePipeline.pipeline = pipelineBuilder.buildPipeline(engine->ctx_.device);
 
+    pipelineBuilder.setShaders(indirectVertShader, fragShader);
+    indirectPipeline.pipeline = pipelineBuilder.buildPipeline(engine->ctx_.device);
+    pipelineBuilder.setShaders(vertShader, fragShader);
+
     pipelineBuilder.enableBlendingAdditive();
     pipelineBuilder.enableDepthTest(false, VK_COMPARE_OP_LESS_OR_EQUAL);
 
     transparentPipeline.pipeline = pipelineBuilder.buildPipeline(engine->ctx_.device);
 
     vkDestroyShaderModule(engine->ctx_.device, vertShader, nullptr);
+    vkDestroyShaderModule(engine->ctx_.device, indirectVertShader, nullptr);
     vkDestroyShaderModule(engine->ctx_.device, fragShader, nullptr);
 }
 
-MaterialInstance GLTFMetallicRoughness::writeMaterial(const VkDevice device, const MaterialPass pass, const MaterialResources &resources, jvk::DynamicDescriptorAllocator &descriptorAllocator) {
+MaterialInstance GLTFMetallicRoughness::writeMaterial(BindlessTable &table, const MaterialPass pass, const GPUMaterial &material) {
     MaterialInstance matData;
     matData.passType = pass;
     if (pass == MaterialPass::TRANSPARENT) {
@@ -82,19 +90,13 @@ MaterialInstance GLTFMetallicRoughness::writeMaterial(const VkDevice device, con
     } else {
         matData.pipeline = &opaquePipeline;
     }
-    matData.materialSet = descriptorAllocator.allocate(device, materialDescriptorLayout);
-
-    writer.clear();
-    writer.writeBuffer(0, resources.dataBuffer, sizeof(MaterialConstants), resources.dataBufferOffset, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-    writer.writeImage(1, resources.colorImage.imageView, resources.colorSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-    writer.writeImage(2, resources.metallicRoughnessImage.imageView, resources.metallicRoughnessSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-    writer.updateSet(device, matData.materialSet);
+    matData.materialIndex = table.addMaterial(material);
 
     return matData;
 }
 
 void GLTFMetallicRoughness::clearResources(const VkDevice device) const {
-    vkDestroyDescriptorSetLayout(device, materialDescriptorLayout, nullptr);
     opaquePipeline.destroy(device, true);
     transparentPipeline.destroy(device);
+    indirectPipeline.destroy(device);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <jvk/buffer.hpp>
 #include <jvk/image.hpp>
 #include <jvk/descriptor.hpp>
+#include <bindless.hpp>
 
 // MATERIALS
 
@@ -21,6 +22,8 @@ enum class MaterialPass : uint8_t {
 struct MaterialPipeline {
     VkPipeline pipeline;
     VkPipelineLayout pipelineLayout;
+    // Small stable id, used in draw sort keys
+    uint32_t id;
 
     void destroy(const VkDevice device, const bool destroyLayout = false) const {
         if (destroyLayout) {
@@ -31,13 +34,14 @@ struct MaterialPipeline {
 };
 
 /**
- * A single instance of a material, containing the required pipeline and descriptors
- * to render that material type
+ * A single instance of a material: the pipeline to render it with and its
+ * slot in the bindless material buffer
  */
 struct MaterialInstance {
     MaterialPipeline *pipeline;
-    VkDescriptorSet materialSet;
     MaterialPass passType;
+    // Pushed with every draw; also used in draw sort keys
+    uint32_t materialIndex;
 };
 
 /**
@@ -52,39 +56,20 @@ struct JVKEngine;
 /**
  * GLTF 2.0 Metallic Roughness Material (Incomplete)
  *
- * Contains pipelines, pipeline layouts, and descriptor set layouts
- * for both material types. Can build and clear resources given an
- * engine pointer.
+ * Contains pipelines and the pipeline layout for both material types.
+ * Material data & textures live in the engine's BindlessTable (set 1).
+ * Can build and clear resources given an engine pointer.
  *
- * Can instantiate a MaterialInstance class given the required resources.
+ * Can instantiate a MaterialInstance class given its GPUMaterial.
  */
 struct GLTFMetallicRoughness {
     MaterialPipeline opaquePipeline;
     MaterialPipeline transparentPipeline;
-    VkDescriptorSetLayout materialDescriptorLayout;
-
-    // To be written to UBO
-    struct MaterialConstants {
-        glm::vec4 colorFactors;
-        glm::vec4 metallicRoughnessFactors;
-        glm::vec4 extra[14];
-    };
-
-    struct MaterialResources {
-        jvk::Image colorImage;
-        VkSampler colorSampler;
-
-        jvk::Image metallicRoughnessImage;
-        VkSampler metallicRoughnessSampler;
-
-        VkBuffer dataBuffer;
-        uint32_t dataBufferOffset;
-    };
-
-    jvk::DescriptorWriter writer;
+    // Opaque, fed by indirect draws: per-draw data comes from the GPUDrawData buffer
+    MaterialPipeline indirectPipeline;
 
     void buildPipelines(JVKEngine *engine);
     void clearResources(VkDevice device) const;
 
-    MaterialInstance writeMaterial(VkDevice device, MaterialPass pass, const MaterialResources &resources, jvk::DynamicDescriptorAllocator &descriptorAllocator);
+    MaterialInstance writeMaterial(BindlessTable &table, MaterialPass pass, const GPUMaterial &material);
 };
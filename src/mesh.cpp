@@ -1,16 +1,22 @@
 #include "engine.hpp"
 
+#include <cache.hpp>
 #include <fastgltf/core.hpp>
 #include <fastgltf/glm_element_traits.hpp>
 #include <fastgltf/tools.hpp>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <ktx.hpp>
 #include <mesh.hpp>
 #include <ranges>
+#include <sorting.hpp>
+#include <texencode.hpp>
+#include <jvk/util.hpp>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 constexpr bool JVK_OVERRIDE_COLORS_WITH_NORMAL_MAP = false;
@@ -21,94 +27,159 @@ constexpr bool JVK_GENERATE_MIPMAPS = true;
 constexpr bool JVK_GENERATE_MIPMAPS = false;
 #endif
 
-void MeshNode::draw(const glm::mat4 &topMatrix, DrawContext &ctx) {
-    glm::mat4 nodeMatrix = topMatrix * worldTransform;
-
-    for (auto &s: mesh->surfaces) {
-        RenderObject rObj;
-        rObj.indexCount  = s.count;
-        rObj.firstIndex  = s.startIndex;
-        rObj.indexBuffer = mesh->meshBuffers.indexBuffer.buffer;
-        rObj.material    = &s.material->data;
+#ifdef JVK_COOK_COMPRESS_TEXTURES
+constexpr bool JVK_COMPRESS_TEXTURES = true;
+#else
+constexpr bool JVK_COMPRESS_TEXTURES = false;
+#endif
 
-        rObj.transform           = nodeMatrix;
-        rObj.vertexBufferAddress = mesh->meshBuffers.vertexBufferAddress;
+// Cooked nodes store parents & mesh ids as the hierarchy does
+static_assert(JVKC_NONE == SceneHierarchy::INVALID);
 
-        if (rObj.material->passType == MaterialPass::TRANSPARENT) {
-            ctx.transparentSurfaces.push_back(rObj);
-        } else {
-            ctx.opaqueSurfaces.push_back(rObj);
+// Loader settings that change what is cooked; part of the cache key
+uint64_t cookSettings(const JVKEngine *engine) {
+    uint64_t settings = JVK_GENERATE_MIPMAPS ? 1 : 0;
+#ifdef JVK_USE_GLTF_ALPHA_MODE
+    settings |= 2;
+#endif
+    // BCn images only load with block compression support
+    if (engine->textureCompressionBCSupported_) {
+        settings |= 4;
+        if (JVK_COMPRESS_TEXTURES) {
+            settings |= 8;
         }
     }
+    return settings;
+}
 
-    Node::draw(topMatrix, ctx);
+// Material of primitives without one; left out of file.materials, which owns (and frees) its slots
+std::shared_ptr<GLTFMaterial> defaultMaterial(const JVKEngine *engine) {
+    std::shared_ptr<GLTFMaterial> material = std::make_shared<GLTFMaterial>();
+    material->data                         = engine->defaultMaterialData_;
+    return material;
 }
 
-std::optional<jvk::Image> loadImage(JVKEngine *engine, fastgltf::Asset &asset, fastgltf::Image &image) {
-    jvk::Image newImage{};
+/**
+ * A decoded image: RGBA8 pixels from stb_image, or the mip chain of a KTX2
+ * texture in its own format. When cooking, the mip chain of RGBA8 images is
+ * built on the CPU instead of the GPU, so it can be stored, and replaces the
+ * pixels; it is then block-compressed if enabled.
+ */
+struct DecodedImage {
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels{nullptr, stbi_image_free};
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    VkExtent3D extent;
+    std::vector<uint8_t> mipChain;
+    uint32_t levelCount = 0;
+    // Channels of the PNG / JPEG
+    int channelCount = 4;
+};
+
+// Only reads the asset, so images can be decoded concurrently
+std::optional<DecodedImage> decodeImage(const fastgltf::Asset &asset, const fastgltf::Image &image, const bool blockCompression) {
+    DecodedImage decoded{};
+    int width, height, nrChannels;
+
+    // ENCODED BYTES
+    std::vector<uint8_t> fileBytes;
+    std::span<const uint8_t> bytes;
 
     // TOP 10 C++ FEATURES I HATE
     std::visit(fastgltf::visitor {
                        [](auto& arg) {},
-                       [&](fastgltf::sources::URI& filePath) {
+                       [&](const fastgltf::sources::URI& filePath) {
                            assert(filePath.fileByteOffset == 0); // We don't support offsets with stbi.
                            assert(filePath.uri.isLocalPath()); // We're only capable of loading local files.
-                           int width, height, nrChannels;
 
                            const std::string path(filePath.uri.path().begin(), filePath.uri.path().end()); // Thanks C++.
-                           unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 4);
-
-                           if (data) {
-                               VkExtent3D imageSize;
-                               imageSize.width = width;
-                               imageSize.height = height;
-                               imageSize.depth = 1;
-
-                               newImage = engine->createImage(data, imageSize, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, JVK_LOADER_GENERATE_MIPMAPS);
-                               stbi_image_free(data);
-                           }
+                           std::ifstream file(path, std::ios::binary | std::ios::ate);
+                           if (!file) return;
+                           fileBytes.resize(static_cast<size_t>(file.tellg()));
+                           file.seekg(0);
+                           file.read(reinterpret_cast<char*>(fileBytes.data()), static_cast<std::streamsize>(fileBytes.size()));
+                           bytes = fileBytes;
                        },
-                       [&](fastgltf::sources::Array& vector) {
-                           int width, height, nrChannels;
-                           unsigned char *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(vector.bytes.data()), static_cast<int>(vector.bytes.size()), &width, &height, &nrChannels, 4);
-                           if (data) {
-                               VkExtent3D imageSize;
-                               imageSize.width = width;
-                               imageSize.height = height;
-                               imageSize.depth = 1;
-
-                               newImage = engine->createImage(data, imageSize, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, JVK_LOADER_GENERATE_MIPMAPS);
-                               stbi_image_free(data);
-                           }
+                       [&](const fastgltf::sources::Array& vector) {
+                           bytes = {reinterpret_cast<const uint8_t*>(vector.bytes.data()), vector.bytes.size()};
                        },
-                       [&](fastgltf::sources::BufferView& view) {
+                       [&](const fastgltf::sources::BufferView& view) {
                            auto& bufferView = asset.bufferViews[view.bufferViewIndex];
                            auto& buffer = asset.buffers[bufferView.bufferIndex];
                            std::visit(fastgltf::visitor {
                                               [](auto& arg) {},
-                                              [&](fastgltf::sources::Array& vector) {
-                                                  int width, height, nrChannels;
-                                                  unsigned char* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(vector.bytes.data() + bufferView.byteOffset),
-                                                                                              static_cast<int>(bufferView.byteLength), &width, &height, &nrChannels, 4);
-                                                  if (data) {
-                                                      VkExtent3D imageSize;
-                                                      imageSize.width = width;
-                                                      imageSize.height = height;
-                                                      imageSize.depth = 1;
-
-                                                      newImage = engine->createImage(data, imageSize, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, JVK_LOADER_GENERATE_MIPMAPS);
-                                                      stbi_image_free(data);
-                                                  }
+                                              [&](const fastgltf::sources::Array& vector) {
+                                                  bytes = {reinterpret_cast<const uint8_t*>(vector.bytes.data() + bufferView.byteOffset), bufferView.byteLength};
                                               }
                                       }, buffer.data);
                        },
                }, image.data);
 
+    // KTX2
+    // Uploaded as stored, block-compressed or not
+    if (isKTX2(bytes)) {
+        std::optional<KTX2Texture> texture = loadKTX2(bytes);
+        if (!texture.has_value()) {
+            return {};
+        }
+        if (jvk::formatBlock(texture->format).width > 1 && !blockCompression) {
+            fmt::println("KTX2: {} needs block compression support", string_VkFormat(texture->format));
+            return {};
+        }
+
+        decoded.format     = texture->format;
+        decoded.extent     = texture->extent;
+        decoded.levelCount = texture->levelCount;
+        decoded.mipChain   = std::move(texture->levels);
+        return decoded;
+    }
 
-    if (newImage.image == VK_NULL_HANDLE) {
+    // PNG / JPEG
+    decoded.pixels.reset(stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height, &nrChannels, 4));
+    if (!decoded.pixels) {
         return {};
     }
-    return newImage;
+    decoded.extent       = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+    decoded.channelCount = nrChannels;
+    return decoded;
+}
+
+// Moves the pixels into a full mip chain built on the CPU
+void buildMipChain(DecodedImage &decoded) {
+    const VkExtent3D extent = decoded.extent;
+    decoded.levelCount      = jvk::mipLevelCount({extent.width, extent.height});
+    decoded.mipChain.resize(jvk::mipChainSize(decoded.format, extent, decoded.levelCount));
+    memcpy(decoded.mipChain.data(), decoded.pixels.get(), jvk::mipLevelSize(decoded.format, extent, 0));
+    decoded.pixels.reset();
+
+    generateMipChain(decoded.mipChain.data(), extent, decoded.levelCount);
+}
+
+// Replaces the RGBA8 levels (or pixels) of a decoded image with their encoding in format
+void compressImage(JobSystem &jobs, DecodedImage &decoded, const VkFormat format) {
+    if (decoded.levelCount == 0) {
+        const VkDeviceSize size = jvk::mipLevelSize(decoded.format, decoded.extent, 0);
+        decoded.levelCount      = 1;
+        decoded.mipChain.assign(decoded.pixels.get(), decoded.pixels.get() + size);
+        decoded.pixels.reset();
+    }
+
+    decoded.mipChain = encodeMipChain(jobs, format, decoded.mipChain.data(), decoded.extent, decoded.levelCount);
+    decoded.format   = format;
+}
+
+// SceneHierarchy::build() drops nodes not reachable from a root (parent cycles); their names must not resolve to them
+void forgetDroppedNodes(LoadedGLTF &file) {
+    const size_t dropped = std::erase_if(file.nodes, [&](const auto &node) { return !file.hierarchy.contains(node.second); });
+    if (dropped > 0) {
+        fmt::println("GLTF: dropped {} nodes not reachable from a root", dropped);
+    }
+}
+
+jvk::Image loadImage(JVKEngine *engine, const DecodedImage &decoded) {
+    if (decoded.levelCount > 0) {
+        return engine->createImage(decoded.mipChain.data(), decoded.extent, decoded.format, VK_IMAGE_USAGE_SAMPLED_BIT, decoded.levelCount);
+    }
+    return engine->createImage(decoded.pixels.get(), decoded.extent, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, JVK_GENERATE_MIPMAPS);
 }
 
 VkFilter extractFilter(fastgltf::Filter filter) {
@@ -137,21 +208,194 @@ VkSamplerMipmapMode extractMipMapMode(fastgltf::Filter filter) {
     }
 }
 
-void LoadedGLTF::draw(const glm::mat4 &topMatrix, DrawContext &ctx) {
-    for (auto &n: topNodes) {
-        n->draw(topMatrix, ctx);
+// Creates the sampler and adds it to the scene & the bindless table
+void loadSampler(JVKEngine *engine, LoadedGLTF &file, const VkFilter magFilter, const VkFilter minFilter, const VkSamplerMipmapMode mipmapMode) {
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType      = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.pNext      = nullptr;
+    samplerInfo.maxLod     = VK_LOD_CLAMP_NONE;
+    samplerInfo.minLod     = 0;
+    samplerInfo.magFilter  = magFilter;
+    samplerInfo.minFilter  = minFilter;
+    samplerInfo.mipmapMode = mipmapMode;
+
+    VkSampler nSampler;
+    vkCreateSampler(engine->ctx_, &samplerInfo, nullptr, &nSampler);
+    file.samplers.push_back(nSampler);
+    file.samplerIndices.push_back(engine->bindless_.addSampler(nSampler));
+}
+
+void LoadedGLTF::buildDrawList() {
+    const uint32_t nodeCount  = hierarchy.size();
+    const uint32_t chunkCount = std::clamp(nodeCount / JVK_MIN_NODES_PER_JOB, 1u, engine->jobs_.workerCount());
+    if (drawChunks_.size() < chunkCount) {
+        drawChunks_.resize(chunkCount);
+    }
+
+    // TRAVERSAL
+    // Each job only touches its own chunk
+    engine->jobs_.parallelFor(chunkCount, 1, [&](const uint32_t firstChunk, const uint32_t lastChunk) {
+        for (uint32_t c = firstChunk; c < lastChunk; ++c) {
+            const uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(nodeCount) * c / chunkCount);
+            const uint32_t last  = static_cast<uint32_t>(static_cast<uint64_t>(nodeCount) * (c + 1) / chunkCount);
+            drawChunks_[c].clear();
+            emitDrawList(first, last, drawChunks_[c]);
+        }
+    });
+
+    if (chunkCount == 1) {
+        // Already final; swap so the chunk keeps the old buffers for the next rebuild
+        DrawListChunk &chunk = drawChunks_[0];
+        chunk.nodeDrawRefs.push_back(static_cast<uint32_t>(chunk.drawRefs.size()));
+        std::swap(drawCtx, chunk.drawCtx);
+        std::swap(drawRefs, chunk.drawRefs);
+        std::swap(nodeDrawRefs, chunk.nodeDrawRefs);
+        movedDraws.clear();
+        drawListDirty = true;
+        return;
+    }
+
+    // CONCATENATION
+    // Chunk offsets are prefix sums, so every chunk is copied into place independently
+    std::vector<uint32_t> opaqueBase(chunkCount), transparentBase(chunkCount), refBase(chunkCount);
+    uint32_t opaqueCount = 0, transparentCount = 0, refCount = 0;
+    for (uint32_t c = 0; c < chunkCount; ++c) {
+        opaqueBase[c]      = opaqueCount;
+        transparentBase[c] = transparentCount;
+        refBase[c]         = refCount;
+        opaqueCount += static_cast<uint32_t>(drawChunks_[c].drawCtx.opaqueSurfaces.size());
+        transparentCount += static_cast<uint32_t>(drawChunks_[c].drawCtx.transparentSurfaces.size());
+        refCount += static_cast<uint32_t>(drawChunks_[c].drawRefs.size());
+    }
+
+    drawCtx.opaqueSurfaces.resize(opaqueCount);
+    drawCtx.transparentSurfaces.resize(transparentCount);
+    drawRefs.resize(refCount);
+    nodeDrawRefs.resize(nodeCount + 1);
+
+    engine->jobs_.parallelFor(chunkCount, 1, [&](const uint32_t firstChunk, const uint32_t lastChunk) {
+        for (uint32_t c = firstChunk; c < lastChunk; ++c) {
+            const DrawListChunk &chunk = drawChunks_[c];
+            std::ranges::copy(chunk.drawCtx.opaqueSurfaces, drawCtx.opaqueSurfaces.begin() + opaqueBase[c]);
+            std::ranges::copy(chunk.drawCtx.transparentSurfaces, drawCtx.transparentSurfaces.begin() + transparentBase[c]);
+
+            for (uint32_t r = 0; r < chunk.drawRefs.size(); ++r) {
+                const DrawRef &ref       = chunk.drawRefs[r];
+                drawRefs[refBase[c] + r] = {ref.transparent, ref.index + (ref.transparent ? transparentBase[c] : opaqueBase[c])};
+            }
+
+            const uint32_t firstNode = static_cast<uint32_t>(static_cast<uint64_t>(nodeCount) * c / chunkCount);
+            for (uint32_t n = 0; n < chunk.nodeDrawRefs.size(); ++n) {
+                nodeDrawRefs[firstNode + n] = chunk.nodeDrawRefs[n] + refBase[c];
+            }
+        }
+    });
+    nodeDrawRefs[nodeCount] = refCount;
+
+    // The engine re-merges the whole list, so earlier moves no longer matter
+    movedDraws.clear();
+    drawListDirty = true;
+}
+
+void LoadedGLTF::emitDrawList(const uint32_t first, const uint32_t last, DrawListChunk &chunk) const {
+    for (uint32_t i = first; i < last; ++i) {
+        chunk.nodeDrawRefs.push_back(static_cast<uint32_t>(chunk.drawRefs.size()));
+        if (!(hierarchy.flags[i] & NODE_FLAG_HAS_MESH)) continue;
+
+        const MeshAsset &mesh     = *meshAssets[hierarchy.meshIds[i]];
+        const glm::mat4 transform = nodeMatrix(i);
+        for (const Surface &s: mesh.surfaces) {
+            RenderObject rObj;
+            rObj.indexCount   = s.count;
+            rObj.firstIndex   = mesh.meshBuffers.allocation.firstIndex + s.startIndex;
+            rObj.vertexOffset = static_cast<int32_t>(mesh.meshBuffers.allocation.vertexOffset);
+            rObj.indexBuffer  = mesh.meshBuffers.indexBuffer;
+            rObj.material     = &s.material->data;
+
+            rObj.transform           = transform;
+            rObj.vertexBufferAddress = mesh.meshBuffers.vertexBufferAddress;
+            rObj.bounds              = s.bounds;
+            rObj.stateKey            = packStateKey(rObj.material->pipeline->id, rObj.material->materialIndex, mesh.meshBuffers.id);
+
+            if (rObj.material->passType == MaterialPass::TRANSPARENT) {
+                chunk.drawRefs.push_back({true, static_cast<uint32_t>(chunk.drawCtx.transparentSurfaces.size())});
+                chunk.drawCtx.transparentSurfaces.push_back(rObj);
+            } else {
+                chunk.drawRefs.push_back({false, static_cast<uint32_t>(chunk.drawCtx.opaqueSurfaces.size())});
+                chunk.drawCtx.opaqueSurfaces.push_back(rObj);
+            }
+        }
+    }
+}
+
+void LoadedGLTF::patchDrawList(const uint32_t first, const uint32_t count) {
+    for (uint32_t i = first; i < first + count; ++i) {
+        if (!(hierarchy.flags[i] & NODE_FLAG_HAS_MESH)) continue;
+
+        const glm::mat4 transform = nodeMatrix(i);
+        for (uint32_t r = nodeDrawRefs[i]; r < nodeDrawRefs[i + 1]; ++r) {
+            const DrawRef &ref = drawRefs[r];
+            RenderObject &rObj = ref.transparent ? drawCtx.transparentSurfaces[ref.index] : drawCtx.opaqueSurfaces[ref.index];
+            rObj.transform     = transform;
+            movedDraws.push_back(ref);
+        }
+    }
+}
+
+void LoadedGLTF::setLocalTransform(const NodeHandle node, const glm::mat4 &localTransform) {
+    hierarchy.setLocalTransform(node, localTransform);
+}
+
+void LoadedGLTF::setTopMatrix(const glm::mat4 &matrix) {
+    topMatrix          = matrix;
+    topMatrixIdentity_ = matrix == glm::mat4{1.0f};
+    topMatrixDirty_    = true;
+}
+
+void LoadedGLTF::update() {
+    if (!topMatrixDirty_ && !hierarchy.dirty()) return;
+
+    updatedRanges_.clear();
+    hierarchy.updateDirtyTransforms(updatedRanges_);
+
+    if (topMatrixDirty_) {
+        // Every RenderObject moves anyway
+        patchDrawList(0, hierarchy.size());
+        topMatrixDirty_ = false;
+    } else {
+        for (const NodeRange &range: updatedRanges_) {
+            patchDrawList(range.first, range.count);
+        }
     }
 }
 
+NodeHandle LoadedGLTF::addNode(const glm::mat4 &localTransform, const uint32_t meshId, const NodeHandle parent) {
+    const NodeHandle node = hierarchy.insert(parent, localTransform, meshId);
+    buildDrawList();
+    return node;
+}
+
+void LoadedGLTF::removeNode(const NodeHandle node) {
+    hierarchy.remove(node);
+    buildDrawList();
+}
+
 void LoadedGLTF::destroy() {
     const VkDevice device = engine->ctx_;
 
-    descriptorPool.destroyPools(device);
-    engine->destroyBuffer(materialDataBuffer);
+    for (const auto &mesh: meshAssets) {
+        engine->freeMesh(mesh->meshBuffers);
+    }
 
-    for (auto &[k, v]: meshes) {
-        engine->destroyBuffer(v->meshBuffers.indexBuffer);
-        engine->destroyBuffer(v->meshBuffers.vertexBuffer);
+    // BINDLESS SLOTS
+    for (auto &[k, v]: materials) {
+        engine->bindless_.freeMaterial(v->data.materialIndex);
+    }
+    for (const uint32_t index: textureIndices) {
+        engine->bindless_.freeTexture(index);
+    }
+    for (const uint32_t index: samplerIndices) {
+        engine->bindless_.freeSampler(index);
     }
 
     for (auto &[k, v]: images) {
@@ -164,9 +408,21 @@ void LoadedGLTF::destroy() {
     }
 }
 
-std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::filesystem::path filePath) {
-    fmt::print("Loading GLTF mesh: {}\n", filePath.string());
+// Adds the local files behind URI sources to the cook's dependencies
+template<typename Source>
+void addURIDependency(CookedSceneWriter &cook, const std::filesystem::path &directory, const Source &source) {
+    if (const auto *filePath = std::get_if<fastgltf::sources::URI>(&source)) {
+        if (filePath->uri.isLocalPath()) {
+            cook.addDependency(directory / std::string(filePath->uri.path().begin(), filePath->uri.path().end()));
+        }
+    }
+}
 
+/**
+ * Parses & converts a glTF file. If cook is given, everything uploaded is
+ * also written to it; mip chains are then built on the CPU.
+ */
+std::optional<std::shared_ptr<LoadedGLTF>> importGLTF(JVKEngine *engine, const std::filesystem::path &filePath, CookedSceneWriter *cook) {
     // SETUP
     std::shared_ptr<LoadedGLTF> scene = std::make_shared<LoadedGLTF>();
     scene->engine                     = engine;
@@ -174,7 +430,7 @@ std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::file
 
     constexpr auto gltfOptions = fastgltf::Options::DontRequireValidAssetMember | fastgltf::Options::AllowDouble | fastgltf::Options::LoadExternalBuffers;
     fastgltf::Asset gltf;
-    fastgltf::Parser parser;
+    fastgltf::Parser parser(fastgltf::Extensions::KHR_texture_basisu);
 
     // LOAD DATA
     auto data = fastgltf::GltfDataBuffer::FromPath(filePath);
@@ -206,110 +462,155 @@ std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::file
         return {};
     }
 
-    // SETUP DESCRIPTOR POOLS
-    std::vector<jvk::DynamicDescriptorAllocator::PoolSizeRatio> sizes = {
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3},
-            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
-            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3}};
-    file.descriptorPool.init(engine->ctx_, gltf.materials.size(), sizes);
+    // DEPENDENCIES
+    // External buffers are loaded into the asset by now, so their URIs come from a parse that leaves them be
+    if (cook) {
+        if (type == fastgltf::GltfType::glTF) {
+            auto references = fastgltf::GltfDataBuffer::FromPath(filePath);
+            if (!references) {
+                fmt::print(stderr, "Failed to load GLTF file");
+                return {};
+            }
+            auto load = parser.loadGltf(references.get(), filePath.parent_path(), fastgltf::Options::DontRequireValidAssetMember | fastgltf::Options::AllowDouble);
+            if (!load) {
+                fmt::print(stderr, "Failed to parse glTF file");
+                return {};
+            }
+            for (const fastgltf::Buffer &buffer: load.get().buffers) {
+                addURIDependency(*cook, filePath.parent_path(), buffer.data);
+            }
+        }
+        for (const fastgltf::Image &image: gltf.images) {
+            addURIDependency(*cook, filePath.parent_path(), image.data);
+        }
+    }
 
     // LOAD SAMPLERS
     for (fastgltf::Sampler &sampler: gltf.samplers) {
-        VkSamplerCreateInfo samplerInfo{};
-        samplerInfo.sType      = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        samplerInfo.pNext      = nullptr;
-        samplerInfo.maxLod     = VK_LOD_CLAMP_NONE;
-        samplerInfo.minLod     = 0;
-        samplerInfo.magFilter  = extractFilter(sampler.magFilter.value_or(fastgltf::Filter::Nearest));
-        samplerInfo.minFilter  = extractFilter(sampler.minFilter.value_or(fastgltf::Filter::Nearest));
-        samplerInfo.mipmapMode = extractMipMapMode(sampler.minFilter.value_or(fastgltf::Filter::Nearest));
+        const VkFilter magFilter             = extractFilter(sampler.magFilter.value_or(fastgltf::Filter::Nearest));
+        const VkFilter minFilter             = extractFilter(sampler.minFilter.value_or(fastgltf::Filter::Nearest));
+        const VkSamplerMipmapMode mipmapMode = extractMipMapMode(sampler.minFilter.value_or(fastgltf::Filter::Nearest));
+        loadSampler(engine, file, magFilter, minFilter, mipmapMode);
 
-        VkSampler nSampler;
-        vkCreateSampler(engine->ctx_, &samplerInfo, nullptr, &nSampler);
-        file.samplers.push_back(nSampler);
+        if (cook) {
+            cook->samplers.push_back({static_cast<uint32_t>(magFilter), static_cast<uint32_t>(minFilter), static_cast<uint32_t>(mipmapMode)});
+        }
     }
 
     // SETUP TEMPORARY ARRAYS
     std::vector<std::shared_ptr<MeshAsset>> meshes;
-    std::vector<std::shared_ptr<Node>> nodes;
-    std::vector<jvk::Image> images;
+    std::vector<uint32_t> imageIndices(gltf.images.size(), engine->errorCheckerboardImageIndex_);
     std::vector<std::shared_ptr<GLTFMaterial>> materials;
 
-    // LOAD TEXTURES
-    int textureIndex = 0;
-    for (fastgltf::Image &image: gltf.images) {
-        std::optional<jvk::Image> img = loadImage(engine, gltf, image);
-        std::string imgName;
-        if (image.name.empty()) {
-            imgName = "texture_" + std::to_string(textureIndex);
-        } else {
-            imgName = image.name;
+    // UPLOADS
+    // Every mesh & texture of the file goes out in one submission
+    engine->uploads_.beginBatch();
+
+    // TEXTURE USAGE
+    // Picks the block format of cooked PNG / JPEG images: BC5 for normal maps & BC4 for single-channel
+    // images, unless they are also sampled for color, BC7 otherwise
+    const size_t imageCount   = gltf.images.size();
+    const bool compressImages = cook && JVK_COMPRESS_TEXTURES && engine->textureCompressionBCSupported_;
+    std::vector<bool> colorImages(imageCount, false);
+    std::vector<bool> normalImages(imageCount, false);
+    for (const fastgltf::Material &mat: gltf.materials) {
+        if (mat.pbrData.baseColorTexture.has_value()) {
+            const fastgltf::Texture &texture = gltf.textures[mat.pbrData.baseColorTexture.value().textureIndex];
+            if (texture.imageIndex.has_value()) colorImages[texture.imageIndex.value()] = true;
         }
-
-        if (img.has_value()) {
-            images.push_back(*img);
-            file.images[imgName] = *img;
-            fmt::print("Texture image loaded: {}\n", imgName);
-        } else {
-            images.push_back(engine->errorCheckerboardImage_);
-            fmt::print("GLTF failed to load texture: {}\n", imgName);
+        if (mat.normalTexture.has_value()) {
+            const fastgltf::Texture &texture = gltf.textures[mat.normalTexture.value().textureIndex];
+            if (texture.imageIndex.has_value()) normalImages[texture.imageIndex.value()] = true;
         }
-        textureIndex++;
     }
+    const auto imageUsage = [&](const size_t i, const DecodedImage &decoded) {
+        if (colorImages[i]) return TextureUsage::Color;
+        if (normalImages[i]) return TextureUsage::Normal;
+        return decoded.channelCount == 1 ? TextureUsage::Mask : TextureUsage::Color;
+    };
+
+    // DECODE TEXTURES
+    // One job per image. Decoded images are uploaded as they complete, in between meshes,
+    // so decoding, mesh conversion & uploads overlap.
+    std::vector<std::optional<DecodedImage>> decodedImages(imageCount);
+    std::vector<JobHandle> decodeJobs(imageCount);
+    std::mutex decodedMutex;
+    std::vector<size_t> decodedQueue;
+    for (size_t i = 0; i < imageCount; ++i) {
+        decodeJobs[i] = engine->jobs_.schedule([&, i] {
+            decodedImages[i] = decodeImage(gltf, gltf.images[i], engine->textureCompressionBCSupported_);
+            if (cook && JVK_GENERATE_MIPMAPS && decodedImages[i].has_value() && decodedImages[i]->pixels) {
+                buildMipChain(*decodedImages[i]);
+            }
+            // Blocks are encoded in parallel, by the workers this job waits on
+            if (compressImages && decodedImages[i].has_value() && decodedImages[i]->format == VK_FORMAT_R8G8B8A8_UNORM) {
+                compressImage(engine->jobs_, *decodedImages[i], blockFormat(imageUsage(i, *decodedImages[i])));
+            }
 
-    // LOAD MATERIALS
-    file.materialDataBuffer                                          = engine->createBuffer(sizeof(GLTFMetallicRoughness::MaterialConstants) * gltf.materials.size(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-    int dataIndex                                                    = 0;
-    GLTFMetallicRoughness::MaterialConstants *sceneMaterialConstants = static_cast<GLTFMetallicRoughness::MaterialConstants *>(file.materialDataBuffer.info.pMappedData);
-    for (fastgltf::Material &mat: gltf.materials) {
-        std::shared_ptr<GLTFMaterial> newMat = std::make_shared<GLTFMaterial>();
-        materials.push_back(newMat);
-        file.materials[mat.name.c_str()] = newMat;
-
-        // MATERIAL CONSTANTS
-        GLTFMetallicRoughness::MaterialConstants constants;
-        constants.colorFactors.x             = mat.pbrData.baseColorFactor[0];
-        constants.colorFactors.y             = mat.pbrData.baseColorFactor[1];
-        constants.colorFactors.z             = mat.pbrData.baseColorFactor[2];
-        constants.colorFactors.a             = mat.pbrData.baseColorFactor[3];
-        constants.metallicRoughnessFactors.x = mat.pbrData.metallicFactor;
-        constants.metallicRoughnessFactors.y = mat.pbrData.roughnessFactor;
-        sceneMaterialConstants[dataIndex]    = constants;
-
-        // MATERIAL PASS
-        MaterialPass passType = MaterialPass::MAIN_COLOR;
+            std::lock_guard lock(decodedMutex);
+            decodedQueue.push_back(i);
+        });
+    }
 
-#ifdef JVK_USE_GLTF_ALPHA_MODE
-        if (mat.alphaMode == fastgltf::AlphaMode::Blend) {
-            passType = MaterialPass::TRANSPARENT;
+    // LOAD TEXTURES
+    if (cook) {
+        cook->images.resize(imageCount);
+    }
+    const auto loadDecodedImages = [&] {
+        std::vector<size_t> ready;
+        {
+            std::lock_guard lock(decodedMutex);
+            ready.swap(decodedQueue);
         }
-#endif
 
-        // MATERIAL RESOURCES
-        GLTFMetallicRoughness::MaterialResources matResources;
-        // Default textures & samplers
-        matResources.colorImage               = engine->whiteImage_;
-        matResources.colorSampler             = engine->defaultSamplerLinear_;
-        matResources.metallicRoughnessImage   = engine->whiteImage_;
-        matResources.metallicRoughnessSampler = engine->defaultSamplerLinear_;
+        for (const size_t i: ready) {
+            fastgltf::Image &image = gltf.images[i];
+            std::string imgName;
+            if (image.name.empty()) {
+                imgName = "texture_" + std::to_string(i);
+            } else {
+                imgName = image.name;
+            }
 
-        // Uniform Buffer
-        matResources.dataBuffer       = file.materialDataBuffer.buffer;
-        matResources.dataBufferOffset = dataIndex * sizeof(GLTFMetallicRoughness::MaterialConstants);
+            if (cook) {
+                CookedImage &cooked = cook->images[i];
+                cooked              = {};
+                cooked.name         = cook->addString(imgName);
+                if (decodedImages[i].has_value()) {
+                    const DecodedImage &decoded = *decodedImages[i];
+                    cooked.extent               = decoded.extent;
+                    cooked.format               = decoded.format;
+                    cooked.levelCount           = std::max(decoded.levelCount, 1u);
+                    cooked.dataSize             = jvk::mipChainSize(decoded.format, decoded.extent, cooked.levelCount);
+                    cooked.dataOffset           = cook->addData(decoded.levelCount > 0 ? decoded.mipChain.data() : decoded.pixels.get(), cooked.dataSize);
+                }
+            }
 
-        // Textures
-        if (mat.pbrData.baseColorTexture.has_value()) {
-            size_t img                = gltf.textures[mat.pbrData.baseColorTexture.value().textureIndex].imageIndex.value();
-            size_t sampler            = gltf.textures[mat.pbrData.baseColorTexture.value().textureIndex].samplerIndex.value();
-            matResources.colorImage   = images[img];
-            matResources.colorSampler = file.samplers[sampler];
+            if (decodedImages[i].has_value()) {
+                const jvk::Image img = loadImage(engine, *decodedImages[i]);
+                decodedImages[i].reset();
+
+                const uint32_t index = engine->bindless_.addTexture(img.imageView);
+                imageIndices[i]      = index;
+                file.textureIndices.push_back(index);
+                file.images[imgName] = img;
+                fmt::print("Texture image loaded: {}\n", imgName);
+            } else {
+                fmt::print("GLTF failed to load texture: {}\n", imgName);
+            }
         }
+    };
 
-        newMat->data = engine->metallicRoughnessMaterial_.writeMaterial(engine->ctx_, passType, matResources, file.descriptorPool);
-        dataIndex++;
+    // CREATE MATERIALS
+    // Meshes reference them; their data is written once every texture is loaded
+    for (fastgltf::Material &mat: gltf.materials) {
+        std::shared_ptr<GLTFMaterial> newMat = std::make_shared<GLTFMaterial>();
+        materials.push_back(newMat);
+        file.materials[mat.name.c_str()] = newMat;
     }
 
     // LOAD MESHES
+    const std::shared_ptr<GLTFMaterial> fallbackMaterial = defaultMaterial(engine);
     std::vector<uint32_t> indices;
     std::vector<Vertex> vertices;
     for (fastgltf::Mesh &mesh: gltf.meshes) {
@@ -391,37 +692,138 @@ std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::file
                 }
             }
 
+            // BOUNDS
+            // A primitive without vertices gets empty bounds at the origin
+            surface.bounds = {glm::vec3(0.0f), 0.0f, glm::vec3(0.0f)};
+            if (vertices.size() > initialVertex) {
+                glm::vec3 minPos = vertices[initialVertex].position;
+                glm::vec3 maxPos = vertices[initialVertex].position;
+                for (size_t i = initialVertex; i < vertices.size(); ++i) {
+                    minPos = glm::min(minPos, vertices[i].position);
+                    maxPos = glm::max(maxPos, vertices[i].position);
+                }
+
+                surface.bounds.origin       = (maxPos + minPos) / 2.0f;
+                surface.bounds.extents      = (maxPos - minPos) / 2.0f;
+                surface.bounds.sphereRadius = glm::length(surface.bounds.extents);
+            }
+
+            uint32_t materialIndex = JVKC_NONE;
             if (p.materialIndex.has_value()) {
-                surface.material = materials[p.materialIndex.value()];
+                materialIndex    = static_cast<uint32_t>(*p.materialIndex);
+                surface.material = materials[materialIndex];
             } else {
-                surface.material = materials[0];
+                surface.material = fallbackMaterial;
             }
 
             newMesh->surfaces.push_back(surface);
+
+            if (cook) {
+                cook->surfaces.push_back({surface.startIndex, surface.count, surface.bounds.origin, surface.bounds.sphereRadius, surface.bounds.extents, materialIndex});
+            }
         }
 
         newMesh->meshBuffers = engine->uploadMesh(indices, vertices);
+
+        if (cook) {
+            CookedMesh cooked{};
+            cooked.name         = cook->addString(mesh.name);
+            cooked.surfaceCount = static_cast<uint32_t>(newMesh->surfaces.size());
+            cooked.firstSurface = static_cast<uint32_t>(cook->surfaces.size()) - cooked.surfaceCount;
+            cooked.vertexCount  = static_cast<uint32_t>(vertices.size());
+            cooked.indexCount   = static_cast<uint32_t>(indices.size());
+            cooked.vertexOffset = cook->addData(vertices.data(), vertices.size() * sizeof(Vertex));
+            cooked.indexOffset  = cook->addData(indices.data(), indices.size() * sizeof(uint32_t));
+            cook->meshes.push_back(cooked);
+        }
+
+        loadDecodedImages();
+    }
+
+    // REMAINING TEXTURES
+    // Waiting runs pending decode jobs on this thread too
+    for (size_t i = 0; i < imageCount; ++i) {
+        engine->jobs_.wait(decodeJobs[i]);
+        loadDecodedImages();
+    }
+    engine->uploads_.endBatch();
+
+    // LOAD MATERIALS
+    for (size_t m = 0; m < gltf.materials.size(); ++m) {
+        fastgltf::Material &mat = gltf.materials[m];
+
+        // MATERIAL CONSTANTS
+        GPUMaterial material{};
+        material.colorFactors.x             = mat.pbrData.baseColorFactor[0];
+        material.colorFactors.y             = mat.pbrData.baseColorFactor[1];
+        material.colorFactors.z             = mat.pbrData.baseColorFactor[2];
+        material.colorFactors.a             = mat.pbrData.baseColorFactor[3];
+        material.metallicRoughnessFactors.x = mat.pbrData.metallicFactor;
+        material.metallicRoughnessFactors.y = mat.pbrData.roughnessFactor;
+
+        // MATERIAL PASS
+        MaterialPass passType = MaterialPass::MAIN_COLOR;
+
+#ifdef JVK_USE_GLTF_ALPHA_MODE
+        if (mat.alphaMode == fastgltf::AlphaMode::Blend) {
+            passType = MaterialPass::TRANSPARENT;
+        }
+#endif
+
+        // MATERIAL RESOURCES
+        // Default textures & samplers
+        material.colorTexture             = engine->whiteImageIndex_;
+        material.colorSampler             = engine->defaultSamplerLinearIndex_;
+        material.metallicRoughnessTexture = engine->whiteImageIndex_;
+        material.metallicRoughnessSampler = engine->defaultSamplerLinearIndex_;
+
+        // Textures
+        uint32_t colorImage   = JVKC_NONE;
+        uint32_t colorSampler = JVKC_NONE;
+        if (mat.pbrData.baseColorTexture.has_value()) {
+            const fastgltf::Texture &texture = gltf.textures[mat.pbrData.baseColorTexture.value().textureIndex];
+
+            // KHR_texture_basisu: the KTX2 image, unless it failed to load and there is a fallback
+            const bool basisuLoaded = texture.basisuImageIndex.has_value() && imageIndices[texture.basisuImageIndex.value()] != engine->errorCheckerboardImageIndex_;
+            size_t img              = basisuLoaded || !texture.imageIndex.has_value() ? texture.basisuImageIndex.value() : texture.imageIndex.value();
+            size_t sampler          = texture.samplerIndex.value();
+            material.colorTexture   = imageIndices[img];
+            material.colorSampler   = file.samplerIndices[sampler];
+            colorImage              = static_cast<uint32_t>(img);
+            colorSampler            = static_cast<uint32_t>(sampler);
+        }
+
+        materials[m]->data = engine->metallicRoughnessMaterial_.writeMaterial(engine->bindless_, passType, material);
+
+        if (cook) {
+            cook->materials.push_back({cook->addString(mat.name), material.colorFactors, material.metallicRoughnessFactors, colorImage, colorSampler, static_cast<uint32_t>(passType)});
+        }
     }
 
     // LOAD NODES
-    for (fastgltf::Node &node: gltf.nodes) {
-        std::shared_ptr<Node> newNode;
+    std::vector<uint32_t> parents(gltf.nodes.size(), SceneHierarchy::INVALID);
+    std::vector<glm::mat4> localTransforms(gltf.nodes.size());
+    std::vector<uint32_t> meshIds(gltf.nodes.size(), SceneHierarchy::INVALID);
+    for (size_t i = 0; i < gltf.nodes.size(); ++i) {
+        fastgltf::Node &node = gltf.nodes[i];
+
+        // The handle of node i has id i (see SceneHierarchy::build)
+        file.nodes[node.name.c_str()] = NodeHandle{static_cast<uint32_t>(i)};
 
-        // NODE TYPE
+        // NODE MESH
         if (node.meshIndex.has_value()) {
-            newNode                                      = std::make_shared<MeshNode>();
-            static_cast<MeshNode *>(newNode.get())->mesh = meshes[*node.meshIndex];
-        } else {
-            newNode = std::make_shared<Node>();
+            meshIds[i] = static_cast<uint32_t>(*node.meshIndex);
         }
 
-        nodes.push_back(newNode);
-        file.nodes[node.name.c_str()];
+        // NODE CHILDREN
+        for (auto &c: node.children) {
+            parents[c] = static_cast<uint32_t>(i);
+        }
 
         // NODE LOCAL TRANSFORM
         std::visit(fastgltf::visitor{
                            [&](fastgltf::math::fmat4x4 matrix) {
-                               memcpy(&newNode->localTransform, matrix.data(), sizeof(matrix));
+                               memcpy(&localTransforms[i], matrix.data(), sizeof(matrix));
                            },
                            [&](fastgltf::TRS transform) {
                                glm::vec3 tl(transform.translation[0], transform.translation[1], transform.translation[2]);
@@ -432,30 +834,176 @@ std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::file
                                glm::mat4 rm = glm::toMat4(rot);
                                glm::mat4 sm = glm::scale(glm::mat4(1.0f), sc);
 
-                               newNode->localTransform = tm * rm * sm;
+                               localTransforms[i] = tm * rm * sm;
                            }},
                    node.transform);
     }
 
+    if (cook) {
+        for (size_t i = 0; i < gltf.nodes.size(); ++i) {
+            cook->nodes.push_back({cook->addString(gltf.nodes[i].name), parents[i], meshIds[i], localTransforms[i]});
+        }
+    }
+
     // BUILD HIERARCHY
-    for (int i = 0; i < gltf.nodes.size(); ++i) {
-        fastgltf::Node &node             = gltf.nodes[i];
-        std::shared_ptr<Node> &sceneNode = nodes[i];
+    file.meshAssets = meshes;
+    file.hierarchy.build(parents, localTransforms, meshIds);
+    forgetDroppedNodes(file);
 
-        for (auto &c: node.children) {
-            sceneNode->children.push_back(nodes[c]);
-            nodes[c]->parent = sceneNode;
+    file.buildDrawList();
+    return scene;
+}
+
+/**
+ * Loads a cooked scene: no parsing, decoding or conversion, every blob is
+ * staged straight from the mapping.
+ */
+std::shared_ptr<LoadedGLTF> loadCookedGLTF(JVKEngine *engine, const CookedScene &cooked) {
+    // SETUP
+    std::shared_ptr<LoadedGLTF> scene = std::make_shared<LoadedGLTF>();
+    scene->engine                     = engine;
+    LoadedGLTF &file                  = *scene.get();
+
+    // LOAD SAMPLERS
+    for (const CookedSampler &sampler: cooked.samplers()) {
+        loadSampler(engine, file, static_cast<VkFilter>(sampler.magFilter), static_cast<VkFilter>(sampler.minFilter), static_cast<VkSamplerMipmapMode>(sampler.mipmapMode));
+    }
+
+    // UPLOADS
+    engine->uploads_.beginBatch();
+
+    // LOAD TEXTURES
+    std::vector<uint32_t> imageIndices(cooked.images().size(), engine->errorCheckerboardImageIndex_);
+    for (size_t i = 0; i < cooked.images().size(); ++i) {
+        const CookedImage &image = cooked.images()[i];
+        const std::string imgName(cooked.string(image.name));
+        if (image.levelCount == 0) {
+            fmt::print("GLTF failed to load texture: {}\n", imgName);
+            continue;
         }
+
+        const jvk::Image img = engine->createImage(cooked.data(image.dataOffset), image.extent, static_cast<VkFormat>(image.format), VK_IMAGE_USAGE_SAMPLED_BIT, image.levelCount);
+        const uint32_t index = engine->bindless_.addTexture(img.imageView);
+        imageIndices[i]      = index;
+        file.textureIndices.push_back(index);
+        file.images[imgName] = img;
     }
 
-    // TOP NODES
-    for (auto &node: nodes) {
-        if (node->parent.lock() == nullptr) {
-            file.topNodes.push_back(node);
-            node->refreshTransform(glm::mat4{1.0f});
+    // LOAD MATERIALS
+    std::vector<std::shared_ptr<GLTFMaterial>> materials;
+    for (const CookedMaterial &mat: cooked.materials()) {
+        std::shared_ptr<GLTFMaterial> newMat = std::make_shared<GLTFMaterial>();
+        materials.push_back(newMat);
+        file.materials[std::string(cooked.string(mat.name))] = newMat;
+
+        GPUMaterial material{};
+        material.colorFactors             = mat.colorFactors;
+        material.metallicRoughnessFactors = mat.metallicRoughnessFactors;
+        material.colorTexture             = mat.colorImage == JVKC_NONE ? engine->whiteImageIndex_ : imageIndices[mat.colorImage];
+        material.colorSampler             = mat.colorSampler == JVKC_NONE ? engine->defaultSamplerLinearIndex_ : file.samplerIndices[mat.colorSampler];
+        material.metallicRoughnessTexture = engine->whiteImageIndex_;
+        material.metallicRoughnessSampler = engine->defaultSamplerLinearIndex_;
+
+        newMat->data = engine->metallicRoughnessMaterial_.writeMaterial(engine->bindless_, static_cast<MaterialPass>(mat.passType), material);
+    }
+
+    // LOAD MESHES
+    const std::shared_ptr<GLTFMaterial> fallbackMaterial = defaultMaterial(engine);
+    std::vector<std::shared_ptr<MeshAsset>> meshes;
+    for (const CookedMesh &mesh: cooked.meshes()) {
+        std::shared_ptr<MeshAsset> newMesh = std::make_shared<MeshAsset>();
+        meshes.push_back(newMesh);
+        newMesh->name              = cooked.string(mesh.name);
+        file.meshes[newMesh->name] = newMesh;
+
+        for (const CookedSurface &cookedSurface: cooked.surfaces().subspan(mesh.firstSurface, mesh.surfaceCount)) {
+            Surface surface;
+            surface.startIndex          = cookedSurface.startIndex;
+            surface.count               = cookedSurface.count;
+            surface.bounds.origin       = cookedSurface.origin;
+            surface.bounds.extents      = cookedSurface.extents;
+            surface.bounds.sphereRadius = cookedSurface.sphereRadius;
+            surface.material            = cookedSurface.material == JVKC_NONE ? fallbackMaterial : materials[cookedSurface.material];
+            newMesh->surfaces.push_back(surface);
         }
+
+        // Blobs are 16-byte aligned in the mapping
+        const std::span indices(static_cast<const uint32_t *>(cooked.data(mesh.indexOffset)), mesh.indexCount);
+        const std::span vertices(static_cast<const Vertex *>(cooked.data(mesh.vertexOffset)), mesh.vertexCount);
+        newMesh->meshBuffers = engine->uploadMesh(indices, vertices);
     }
+    engine->uploads_.endBatch();
+
+    // LOAD NODES
+    const size_t nodeCount = cooked.nodes().size();
+    std::vector<uint32_t> parents(nodeCount);
+    std::vector<glm::mat4> localTransforms(nodeCount);
+    std::vector<uint32_t> meshIds(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        const CookedNode &node = cooked.nodes()[i];
+
+        // The handle of node i has id i (see SceneHierarchy::build)
+        file.nodes[std::string(cooked.string(node.name))] = NodeHandle{static_cast<uint32_t>(i)};
+        parents[i]                                         = node.parent;
+        localTransforms[i]                                 = node.localTransform;
+        meshIds[i]                                         = node.meshId;
+    }
+
+    // BUILD HIERARCHY
+    file.meshAssets = meshes;
+    file.hierarchy.build(parents, localTransforms, meshIds);
+    forgetDroppedNodes(file);
+
+    file.buildDrawList();
+    return scene;
+}
 
-    fmt::print("Finished loading GLTF\n");
+std::optional<std::shared_ptr<LoadedGLTF>> loadGLTF(JVKEngine *engine, std::filesystem::path filePath) {
+    fmt::print("Loading GLTF mesh: {}\n", filePath.string());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::optional<std::shared_ptr<LoadedGLTF>> scene;
+    if (engine->assetCache_) {
+        // SOURCE HASH
+        MappedFile source;
+        if (!source.open(filePath)) {
+            fmt::print(stderr, "Failed to load GLTF file");
+            return {};
+        }
+        const uint64_t sourceHash = hashBytes(source.data(), source.size(), cookSettings(engine));
+        source.close();
+
+        std::filesystem::path cachePath = filePath;
+        cachePath += ".jvkc";
+
+        // WARM START
+        CookedScene cooked;
+        if (cooked.open(cachePath, sourceHash)) {
+            scene = loadCookedGLTF(engine, cooked);
+        } else {
+            // COOK
+            CookedSceneWriter cook;
+            const bool cooking = cook.open(cachePath, sourceHash);
+            if (!cooking) {
+                fmt::print("Failed to create cooked scene: {}\n", cachePath.string());
+            }
+
+            scene = importGLTF(engine, filePath, cooking ? &cook : nullptr);
+            if (cooking) {
+                if (scene.has_value() && cook.finish()) {
+                    fmt::print("Cooked GLTF into: {}\n", cachePath.string());
+                } else {
+                    cook.abandon();
+                }
+            }
+        }
+    } else {
+        scene = importGLTF(engine, filePath, nullptr);
+    }
+
+    if (scene.has_value()) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        fmt::print("Finished loading GLTF in {:.1f} ms\n", elapsed.count() / 1000.0f);
+    }
     return scene;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "fastgltf/types.hpp"
 #include "material.hpp"
+#include "geometry.hpp"
+#include "hierarchy.hpp"
 
 #include <filesystem>
 #include <jvk.hpp>
@@ -24,12 +26,15 @@ struct Vertex {
 };
 
 /**
- * Contains the index/vertex buffers for a mesh
+ * A mesh's slice of the engine's geometry arena, plus the arena's
+ * index buffer and vertex buffer address to draw it with
  */
 struct GPUMeshBuffers {
-    jvk::Buffer indexBuffer;
-    jvk::Buffer vertexBuffer;
+    GeometryAllocation allocation;
+    VkBuffer indexBuffer;
     VkDeviceAddress vertexBufferAddress;
+    // Small stable id, used in draw sort keys
+    uint32_t id;
 };
 
 /**
@@ -46,12 +51,48 @@ struct GPUSceneData {
 
 /**
  * Global push constants. Contains:
- *  - worldMatrix: The world matrix transform
  *  - vertexBuffer: The address of the vertex buffer
+ *  - transformBuffer: The address of the frame's transform buffer
+ *  - instanceBuffer: The address of the frame's instance buffer, which maps
+ *    gl_InstanceIndex to a slot in the transform buffer
+ *  - materialIndex: The material's slot in the bindless material buffer
+ *
+ * The addresses are pushed once per pipeline bind; draws only push the material
+ * index, and only when it changes.
  */
 struct GPUDrawPushConstants {
-    glm::mat4 worldMatrix;
     VkDeviceAddress vertexBuffer;
+    VkDeviceAddress transformBuffer;
+    VkDeviceAddress instanceBuffer;
+    uint32_t materialIndex;
+};
+
+/**
+ * Per-surface data for GPU-driven rendering, read by shaders/cull.comp and
+ * shaders/mesh_indirect.vert (see DrawData in shaders/draw_structures.glsl)
+ */
+struct GPUDrawData {
+    glm::vec4 boundingSphere;// World space: xyz center, w radius
+    VkDeviceAddress vertexBuffer;
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    uint32_t batch;        // Slot in the indirect count buffer
+    uint32_t commandOffset;// First indirect command of the batch
+    int32_t vertexOffset;
+    uint32_t materialIndex;
+    uint32_t objectIndex;// Slot in the frame's transform buffer
+    uint32_t pad[3];
+};
+static_assert(sizeof(GPUDrawData) == 64, "GPUDrawData must match the std430 layout of DrawData");
+
+/**
+ * Local-space bounds of a surface: an AABB (origin +- extents) and the
+ * bounding sphere around the same origin.
+ */
+struct Bounds {
+    glm::vec3 origin;
+    float sphereRadius;
+    glm::vec3 extents;
 };
 
 /**
@@ -64,6 +105,7 @@ struct GPUDrawPushConstants {
 struct Surface {
     uint32_t startIndex;
     uint32_t count;
+    Bounds bounds;
     std::shared_ptr<GLTFMaterial> material;
 };
 
@@ -87,94 +129,135 @@ struct MeshAsset {
 struct RenderObject {
     uint32_t indexCount;
     uint32_t firstIndex;
+    int32_t vertexOffset;
     VkBuffer indexBuffer;
 
     MaterialInstance *material;
 
     glm::mat4 transform;
     VkDeviceAddress vertexBufferAddress;
+
+    Bounds bounds;
+
+    // Pipeline/material/index buffer part of the draw sort key (see sorting.hpp)
+    uint64_t stateKey;
 };
 
 /**
  * A context for drawing, containing a list of opaque and transparent
- * surfaces to render. Should be updated per frame.
+ * surfaces to render. Retained across frames: only rebuilt or patched
+ * when the scene changes.
  */
 struct DrawContext {
     std::vector<RenderObject> opaqueSurfaces;
     std::vector<RenderObject> transparentSurfaces;
-};
 
-/**
- * A generic renderable object. Can be a mesh, a node, or a scene.
- *
- * TODO: look to replace this with an ECS or something
- */
-class IRenderable {
-    virtual void draw(const glm::mat4 &topMatrix, DrawContext &ctx) = 0;
+    void clear() {
+        opaqueSurfaces.clear();
+        transparentSurfaces.clear();
+    }
 };
 
 /**
- * A generic node in a scene graph. Contains a local and world transform.
- *
- * The transforms can be updated by calling refreshTransform with the parent
- * Calling draw() will simply call draw() on all children.
+ * Location of a retained RenderObject inside a DrawContext
  */
-struct Node : public IRenderable {
-    std::weak_ptr<Node> parent;
-    std::vector<std::shared_ptr<Node>> children;
-
-    glm::mat4 localTransform;
-    glm::mat4 worldTransform;
-
-    void refreshTransform(const glm::mat4 &parentMatrix) {
-        worldTransform = parentMatrix * localTransform;
-        for (const auto &child : children) {
-            child->refreshTransform(worldTransform);
-        }
-    }
-
-    virtual void draw(const glm::mat4 &topMatrix, DrawContext &ctx) override {
-        for (const auto &child : children) {
-            child->draw(topMatrix, ctx);
-        }
-    }
+struct DrawRef {
+    bool transparent;
+    uint32_t index;
 };
 
+// Fewer nodes than this per job are traversed on the calling thread
+constexpr uint32_t JVK_MIN_NODES_PER_JOB = 512;
+
 /**
- * A node that contains a mesh asset. Calling draw() will
- * generate a RenderObject and pass it into the draw context
+ * The draw list of one contiguous node range, built by one job. Ref indices
+ * and node offsets are local to the chunk until concatenated.
  */
-struct MeshNode : public Node {
-    std::shared_ptr<MeshAsset> mesh;
+struct DrawListChunk {
+    DrawContext drawCtx;
+    std::vector<DrawRef> drawRefs;
+    std::vector<uint32_t> nodeDrawRefs;
 
-    virtual void draw(const glm::mat4 &topMatrix, DrawContext &ctx) override;
+    void clear() {
+        drawCtx.clear();
+        drawRefs.clear();
+        nodeDrawRefs.clear();
+    }
 };
 
 /**
- * Represents a fully loaded glTF 2.0 file, which see view as a scene.
- *
- * Calling draw() on this will process all of it's child MeshNodes
+ * A loaded glTF scene: its GPU resources, its node hierarchy and the
+ * retained draw list built from it.
  */
-struct LoadedGLTF : public IRenderable {
+struct LoadedGLTF {
     std::unordered_map<std::string, std::shared_ptr<MeshAsset>> meshes;
-    std::unordered_map<std::string, std::shared_ptr<Node>> nodes;
+    std::unordered_map<std::string, NodeHandle> nodes;
     std::unordered_map<std::string, jvk::Image> images;
     std::unordered_map<std::string, std::shared_ptr<GLTFMaterial>> materials;
 
-    std::vector<std::shared_ptr<Node>> topNodes;
+    // Indexed by the hierarchy's mesh ids
+    std::vector<std::shared_ptr<MeshAsset>> meshAssets;
     std::vector<VkSampler> samplers;
 
-    jvk::DynamicDescriptorAllocator descriptorPool;
-
-    jvk::Buffer materialDataBuffer;
+    // Bindless slots owned by this scene; materials hold their own
+    std::vector<uint32_t> textureIndices;
+    std::vector<uint32_t> samplerIndices;
 
     JVKEngine *engine;
 
+    SceneHierarchy hierarchy;
+
+    // RETAINED DRAW LIST
+    // Emitted in node order: the RenderObjects of node i are drawRefs[nodeDrawRefs[i], nodeDrawRefs[i + 1])
+    DrawContext drawCtx;
+    glm::mat4 topMatrix{1.0f};
+    std::vector<DrawRef> drawRefs;
+    std::vector<uint32_t> nodeDrawRefs;
+    // Set when drawCtx is rebuilt; cleared by the engine after merging
+    bool drawListDirty = true;
+    // RenderObjects whose transform update() rewrote since the engine last read them
+    std::vector<DrawRef> movedDraws;
+    // Offsets of drawCtx's surfaces in the engine's merged draw list, set when merging
+    uint32_t mergedOpaqueBase      = 0;
+    uint32_t mergedTransparentBase = 0;
+
     ~LoadedGLTF() { destroy(); };
 
-    virtual void draw(const glm::mat4 &topMatrix, DrawContext &ctx);
+    /**
+     * Rebuilds drawCtx from the hierarchy. Large scenes are split into node
+     * ranges traversed by separate jobs, then concatenated in node order.
+     */
+    void buildDrawList();
+
+    // Both are deferred to update(); repeated or nested changes in one frame are applied once
+    void setLocalTransform(NodeHandle node, const glm::mat4 &localTransform);
+    void setTopMatrix(const glm::mat4 &matrix);
+
+    /**
+     * Applies pending transform changes: recomputes dirty subtrees and patches
+     * only their RenderObjects, or every RenderObject if the top matrix changed,
+     * recording them in movedDraws. Does nothing for a static scene.
+     */
+    void update();
+
+    // Structural changes rebuild the draw list
+    NodeHandle addNode(const glm::mat4 &localTransform, uint32_t meshId = SceneHierarchy::INVALID, NodeHandle parent = {});
+    void removeNode(NodeHandle node);
 
 private:
+    bool topMatrixDirty_    = false;
+    bool topMatrixIdentity_ = true;
+    std::vector<NodeRange> updatedRanges_;
+    // Reused across rebuilds
+    std::vector<DrawListChunk> drawChunks_;
+
+    glm::mat4 nodeMatrix(const uint32_t index) const {
+        return topMatrixIdentity_ ? hierarchy.worldTransforms[index] : topMatrix * hierarchy.worldTransforms[index];
+    }
+    // Appends the RenderObjects of nodes [first, last) to chunk
+    void emitDrawList(uint32_t first, uint32_t last, DrawListChunk &chunk) const;
+    // Rewrites the transforms of the RenderObjects of nodes [first, first + count) & adds them to movedDraws
+    void patchDrawList(uint32_t first, uint32_t count);
     void destroy();
 };
 
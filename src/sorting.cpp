@@ -0,0 +1,55 @@
+#include <sorting.hpp>
+
+#include <cstring>
+
+void radixSort(uint64_t *keys, uint32_t *values, uint64_t *keysTmp, uint32_t *valuesTmp, const uint32_t count) {
+    constexpr uint32_t PASSES = 8;
+    constexpr uint32_t RADIX  = 256;
+
+    if (count < 2) return;
+
+    // All histograms in a single read of the keys
+    uint32_t histograms[PASSES][RADIX] = {};
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint64_t key = keys[i];
+        for (uint32_t p = 0; p < PASSES; ++p) {
+            histograms[p][(key >> (p * 8)) & 0xFF]++;
+        }
+    }
+
+    uint64_t *srcKeys   = keys;
+    uint32_t *srcValues = values;
+    uint64_t *dstKeys   = keysTmp;
+    uint32_t *dstValues = valuesTmp;
+
+    for (uint32_t p = 0; p < PASSES; ++p) {
+        const uint32_t shift = p * 8;
+        uint32_t *histogram  = histograms[p];
+
+        // Every key has the same digit; this pass would be a copy
+        if (histogram[(srcKeys[0] >> shift) & 0xFF] == count) continue;
+
+        // Exclusive prefix sum -> output offsets
+        uint32_t offset = 0;
+        for (uint32_t d = 0; d < RADIX; ++d) {
+            const uint32_t n = histogram[d];
+            histogram[d]     = offset;
+            offset += n;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t dst = histogram[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[dst]       = srcKeys[i];
+            dstValues[dst]     = srcValues[i];
+        }
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // Odd number of scatter passes: result is in the scratch arrays
+    if (srcKeys != keys) {
+        std::memcpy(keys, srcKeys, count * sizeof(uint64_t));
+        std::memcpy(values, srcValues, count * sizeof(uint32_t));
+    }
+}
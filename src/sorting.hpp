@@ -0,0 +1,54 @@
+#pragma once
+
+#include <jvk.hpp>
+
+#include <bit>
+
+/**
+ * Order of opaque draws:
+ *  - STATE: pipeline, material, index buffer, then front-to-back within a state
+ *  - FRONT_TO_BACK: nearest first (early-z), state only breaks ties
+ */
+enum class DrawSortMode : uint8_t {
+    STATE,
+    FRONT_TO_BACK
+};
+
+// SORT KEYS
+// The state part of a key is built during scene traversal and stored in the RenderObject;
+// quantized view depth is merged in per frame.
+//  STATE:         [63..56 pipeline][55..36 material][35..20 index buffer][19..0 depth]
+//  FRONT_TO_BACK: [63..44 depth][43..36 pipeline][35..16 material][15..0 index buffer]
+constexpr uint32_t JVK_SORT_STATE_BITS = 44;
+constexpr uint32_t JVK_SORT_DEPTH_BITS = 20;
+
+constexpr uint64_t packStateKey(const uint32_t pipelineId, const uint32_t materialId, const uint32_t indexBufferId) {
+    return (static_cast<uint64_t>(pipelineId & 0xFF) << 36) |
+           (static_cast<uint64_t>(materialId & 0xFFFFF) << 16) |
+           (static_cast<uint64_t>(indexBufferId & 0xFFFF));
+}
+
+/**
+ * Quantizes a view-space depth to JVK_SORT_DEPTH_BITS. Uses the top bits of the
+ * float representation, which are monotonic for positive values, so no near/far
+ * range is needed.
+ */
+inline uint32_t quantizeDepth(const float depth) {
+    const float clamped = depth > 0.0f ? depth : 0.0f;
+    return std::bit_cast<uint32_t>(clamped) >> (31 - JVK_SORT_DEPTH_BITS);
+}
+
+constexpr uint64_t makeSortKey(const DrawSortMode mode, const uint64_t stateKey, const uint32_t depth) {
+    if (mode == DrawSortMode::FRONT_TO_BACK) {
+        return (static_cast<uint64_t>(depth) << JVK_SORT_STATE_BITS) | stateKey;
+    }
+    return (stateKey << JVK_SORT_DEPTH_BITS) | depth;
+}
+
+/**
+ * Stable LSD radix sort of 64-bit keys with 32-bit payloads, 8 bits per pass.
+ * Passes where every key shares the same digit are skipped. Does not allocate:
+ * keysTmp/valuesTmp are scratch arrays of at least count entries. The sorted
+ * result is written back to keys/values.
+ */
+void radixSort(uint64_t *keys, uint32_t *values, uint64_t *keysTmp, uint32_t *valuesTmp, uint32_t count);
@@ -0,0 +1,3 @@
+// The one stb_image implementation, shared by the glTF loader and the texture cooker
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
@@ -0,0 +1,122 @@
+#include <jobs.hpp>
+#include <ktx.hpp>
+#include <texencode.hpp>
+#include <jvk/util.hpp>
+
+#include <chrono>
+#include <cstring>
+
+#include <stb_image.h>
+
+// Usage: jvk_texcook input.png output.ktx2 [--usage color|normal|mask] [--format bc1|bc4|bc5|bc7] [--srgb] [--no-mips]
+int main(int argc, char **argv) {
+    std::vector<std::string> paths;
+    std::optional<TextureUsage> usage;
+    std::optional<VkFormat> format;
+    bool srgb    = false;
+    bool mipmaps = true;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (!arg.starts_with("--")) {
+            paths.push_back(arg);
+            continue;
+        }
+        if (arg == "--srgb") {
+            srgb = true;
+            continue;
+        }
+        if (arg == "--no-mips") {
+            mipmaps = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fmt::println(stderr, "Missing value for argument: {}", arg);
+            return 1;
+        }
+
+        if (arg == "--usage") {
+            const std::string value = argv[++i];
+            if (value == "color") {
+                usage = TextureUsage::Color;
+            } else if (value == "normal") {
+                usage = TextureUsage::Normal;
+            } else if (value == "mask") {
+                usage = TextureUsage::Mask;
+            } else {
+                fmt::println(stderr, "Unknown usage: {}", value);
+                return 1;
+            }
+        } else if (arg == "--format") {
+            const std::string value = argv[++i];
+            if (value == "bc1") {
+                format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            } else if (value == "bc4") {
+                format = VK_FORMAT_BC4_UNORM_BLOCK;
+            } else if (value == "bc5") {
+                format = VK_FORMAT_BC5_UNORM_BLOCK;
+            } else if (value == "bc7") {
+                format = VK_FORMAT_BC7_UNORM_BLOCK;
+            } else {
+                fmt::println(stderr, "Unknown format: {}", value);
+                return 1;
+            }
+        } else {
+            fmt::println(stderr, "Unknown argument: {}", arg);
+            return 1;
+        }
+    }
+    if (paths.size() != 2) {
+        fmt::println(stderr, "Usage: jvk_texcook input.png output.ktx2 [--usage color|normal|mask] [--format bc1|bc4|bc5|bc7] [--srgb] [--no-mips]");
+        return 1;
+    }
+
+    // DECODE
+    int width, height, channelCount;
+    stbi_uc *pixels = stbi_load(paths[0].c_str(), &width, &height, &channelCount, 4);
+    if (!pixels) {
+        fmt::println(stderr, "Failed to load image: {}", paths[0]);
+        return 1;
+    }
+    const VkExtent3D extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+
+    // FORMAT
+    // Single-channel images default to masks, like the loader's
+    if (!format.has_value()) {
+        format = blockFormat(usage.value_or(channelCount == 1 ? TextureUsage::Mask : TextureUsage::Color));
+    }
+    if (srgb) {
+        if (format == VK_FORMAT_BC1_RGB_UNORM_BLOCK) {
+            format = VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        } else if (format == VK_FORMAT_BC7_UNORM_BLOCK) {
+            format = VK_FORMAT_BC7_SRGB_BLOCK;
+        } else {
+            fmt::println(stderr, "{} has no sRGB variant", string_VkFormat(*format));
+            return 1;
+        }
+    }
+
+    // MIP CHAIN
+    const uint32_t levelCount = mipmaps ? jvk::mipLevelCount({extent.width, extent.height}) : 1;
+    std::vector<uint8_t> levels(jvk::mipChainSize(VK_FORMAT_R8G8B8A8_UNORM, extent, levelCount));
+    memcpy(levels.data(), pixels, jvk::mipLevelSize(VK_FORMAT_R8G8B8A8_UNORM, extent, 0));
+    stbi_image_free(pixels);
+    generateMipChain(levels.data(), extent, levelCount);
+
+    // ENCODE
+    JobSystem jobs;
+    jobs.init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    KTX2Texture texture{*format, extent, levelCount, encodeMipChain(jobs, *format, levels.data(), extent, levelCount)};
+    const auto end = std::chrono::steady_clock::now();
+
+    jobs.destroy();
+
+    if (!writeKTX2(paths[1], texture)) {
+        return 1;
+    }
+    fmt::println("{}: {}x{}, {} levels of {} in {:.1f} ms ({} -> {} bytes)", paths[1], extent.width, extent.height, levelCount,
+                 string_VkFormat(*format), std::chrono::duration<float, std::milli>(end - start).count(), levels.size(), texture.levels.size());
+    return 0;
+}
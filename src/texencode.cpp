@@ -0,0 +1,525 @@
+#include <texencode.hpp>
+
+#include <jobs.hpp>
+#include <jvk/util.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// BC7 interpolation weights of 4-bit indices, out of 64
+constexpr uint32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+namespace {
+
+// A 4x4 block of texels, one row of 16 per channel, in the 0-255 range
+struct Block {
+    alignas(32) float channels[4][16];
+};
+
+// Endpoints & palette entries, in the same range as the block
+using Color = float[4];
+
+// Accumulates the bits of a block, LSB first
+struct BlockWriter {
+    uint64_t words[2] = {};
+    uint32_t offset   = 0;
+
+    void write(const uint64_t value, const uint32_t count) {
+        const uint32_t word  = offset / 64;
+        const uint32_t shift = offset % 64;
+        words[word] |= value << shift;
+        if (shift + count > 64) {
+            words[word + 1] |= value >> (64 - shift);
+        }
+        offset += count;
+    }
+};
+
+// Texels past the edges of the image repeat the last row & column
+void readBlock(const uint8_t *rgba, const VkExtent2D extent, const uint32_t blockX, const uint32_t blockY, Block &block) {
+    for (uint32_t y = 0; y < 4; ++y) {
+        const uint32_t row = std::min(blockY * 4 + y, extent.height - 1);
+        for (uint32_t x = 0; x < 4; ++x) {
+            const uint32_t column = std::min(blockX * 4 + x, extent.width - 1);
+            const uint8_t *texel  = rgba + (static_cast<size_t>(row) * extent.width + column) * 4;
+            for (uint32_t c = 0; c < 4; ++c) {
+                block.channels[c][y * 4 + x] = texel[c];
+            }
+        }
+    }
+}
+
+/**
+ * Picks, for each texel, the nearest of count palette entries over the first
+ * channelCount channels. Returns the summed squared error.
+ */
+float selectIndices(const Block &block, const uint32_t channelCount, const Color *palette, const uint32_t count, uint8_t indices[16]) {
+    alignas(32) int32_t nearest[16];
+    alignas(32) float error[16];
+
+#if defined(__AVX__)
+    for (uint32_t first = 0; first < 16; first += 8) {
+        __m256 bestError = _mm256_set1_ps(FLT_MAX);
+        __m256 bestIndex = _mm256_setzero_ps();
+        for (uint32_t k = 0; k < count; ++k) {
+            __m256 d = _mm256_setzero_ps();
+            for (uint32_t c = 0; c < channelCount; ++c) {
+                const __m256 diff = _mm256_sub_ps(_mm256_load_ps(block.channels[c] + first), _mm256_set1_ps(palette[k][c]));
+                d                 = _mm256_add_ps(_mm256_mul_ps(diff, diff), d);
+            }
+            const __m256 closer = _mm256_cmp_ps(d, bestError, _CMP_LT_OQ);
+            bestError           = _mm256_min_ps(d, bestError);
+            bestIndex           = _mm256_blendv_ps(bestIndex, _mm256_set1_ps(static_cast<float>(k)), closer);
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i *>(nearest + first), _mm256_cvttps_epi32(bestIndex));
+        _mm256_store_ps(error + first, bestError);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (uint32_t first = 0; first < 16; first += 4) {
+        __m128 bestError = _mm_set1_ps(FLT_MAX);
+        __m128 bestIndex = _mm_setzero_ps();
+        for (uint32_t k = 0; k < count; ++k) {
+            __m128 d = _mm_setzero_ps();
+            for (uint32_t c = 0; c < channelCount; ++c) {
+                const __m128 diff = _mm_sub_ps(_mm_load_ps(block.channels[c] + first), _mm_set1_ps(palette[k][c]));
+                d                 = _mm_add_ps(_mm_mul_ps(diff, diff), d);
+            }
+            const __m128 closer = _mm_cmplt_ps(d, bestError);
+            bestError           = _mm_min_ps(d, bestError);
+            bestIndex           = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(k))), _mm_andnot_ps(closer, bestIndex));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i *>(nearest + first), _mm_cvttps_epi32(bestIndex));
+        _mm_store_ps(error + first, bestError);
+    }
+#else
+    for (uint32_t i = 0; i < 16; ++i) {
+        error[i]   = FLT_MAX;
+        nearest[i] = 0;
+        for (uint32_t k = 0; k < count; ++k) {
+            float d = 0.0f;
+            for (uint32_t c = 0; c < channelCount; ++c) {
+                const float diff = block.channels[c][i] - palette[k][c];
+                d += diff * diff;
+            }
+            if (d < error[i]) {
+                error[i]   = d;
+                nearest[i] = static_cast<int32_t>(k);
+            }
+        }
+    }
+#endif
+
+    float total = 0.0f;
+    for (uint32_t i = 0; i < 16; ++i) {
+        indices[i] = static_cast<uint8_t>(nearest[i]);
+        total += error[i];
+    }
+    return total;
+}
+
+// Endpoints at the extremes of the block along its principal axis
+void fitPrincipalAxis(const Block &block, const uint32_t channelCount, Color lo, Color hi) {
+    float mean[4]   = {};
+    float axis[4]   = {};
+    float cov[4][4] = {};
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        float minimum = FLT_MAX, maximum = -FLT_MAX;
+        for (const float v: block.channels[c]) {
+            mean[c] += v;
+            minimum = std::min(minimum, v);
+            maximum = std::max(maximum, v);
+        }
+        mean[c] /= 16.0f;
+        // Power iteration starts from the extents of the block
+        axis[c] = maximum - minimum;
+    }
+    for (uint32_t i = 0; i < 16; ++i) {
+        for (uint32_t a = 0; a < channelCount; ++a) {
+            for (uint32_t b = 0; b < channelCount; ++b) {
+                cov[a][b] += (block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]);
+            }
+        }
+    }
+
+    for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        float largest = 0.0f;
+        for (uint32_t a = 0; a < channelCount; ++a) {
+            for (uint32_t b = 0; b < channelCount; ++b) {
+                next[a] += cov[a][b] * axis[b];
+            }
+            largest = std::max(largest, std::abs(next[a]));
+        }
+        if (largest == 0.0f) break;
+        for (uint32_t c = 0; c < channelCount; ++c) {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    float length = 0.0f;
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        length += axis[c] * axis[c];
+    }
+    length = std::sqrt(length);
+
+    // Flat block: both endpoints at the mean
+    float tMin = 0.0f, tMax = 0.0f;
+    if (length > 0.0f) {
+        tMin = FLT_MAX;
+        tMax = -FLT_MAX;
+        for (uint32_t i = 0; i < 16; ++i) {
+            float t = 0.0f;
+            for (uint32_t c = 0; c < channelCount; ++c) {
+                t += (block.channels[c][i] - mean[c]) * axis[c] / length;
+            }
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+    }
+
+    for (uint32_t c = 0; c < 4; ++c) {
+        const float direction = c < channelCount && length > 0.0f ? axis[c] / length : 0.0f;
+        lo[c]                 = std::clamp(mean[c] + direction * tMin, 0.0f, 255.0f);
+        hi[c]                 = std::clamp(mean[c] + direction * tMax, 0.0f, 255.0f);
+    }
+}
+
+/**
+ * Least-squares endpoints for the given interpolation weights (0 at lo, 1
+ * at hi) of each texel; false if the weights cannot determine them.
+ */
+bool refineEndpoints(const Block &block, const uint32_t channelCount, const float weights[16], Color lo, Color hi) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float sumA[4] = {}, sumB[4] = {};
+    for (uint32_t i = 0; i < 16; ++i) {
+        const float b = weights[i];
+        const float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (uint32_t c = 0; c < channelCount; ++c) {
+            sumA[c] += a * block.channels[c][i];
+            sumB[c] += b * block.channels[c][i];
+        }
+    }
+
+    const float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) {
+        return false;
+    }
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        lo[c] = std::clamp((bb * sumA[c] - ab * sumB[c]) / det, 0.0f, 255.0f);
+        hi[c] = std::clamp((aa * sumB[c] - ab * sumA[c]) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// BC1
+// Opaque: color0 > color1 selects the 4-color mode
+
+uint16_t packRGB565(const Color color) {
+    const uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+    const uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+    const uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+void unpackRGB565(const uint16_t packed, Color color) {
+    const uint32_t r = packed >> 11 & 31;
+    const uint32_t g = packed >> 5 & 63;
+    const uint32_t b = packed & 31;
+    color[0]         = static_cast<float>(r << 3 | r >> 2);
+    color[1]         = static_cast<float>(g << 2 | g >> 4);
+    color[2]         = static_cast<float>(b << 3 | b >> 2);
+    color[3]         = 255.0f;
+}
+
+// Quantizes the endpoints, then picks the indices; returns the error
+float evaluateBC1(const Block &block, const Color lo, const Color hi, uint16_t &color0, uint16_t &color1, uint8_t indices[16]) {
+    color0 = packRGB565(hi);
+    color1 = packRGB565(lo);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    Color palette[4];
+    unpackRGB565(color0, palette[0]);
+    unpackRGB565(color1, palette[1]);
+    for (uint32_t c = 0; c < 3; ++c) {
+        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+
+    // Equal endpoints select the 3-color mode, whose index 3 is transparent
+    return selectIndices(block, 3, palette, color0 == color1 ? 1 : 4, indices);
+}
+
+void encodeBC1(const Block &block, uint8_t *dst) {
+    constexpr float WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+    Color lo, hi;
+    fitPrincipalAxis(block, 3, lo, hi);
+
+    uint16_t color0, color1;
+    uint8_t indices[16];
+    const float error = evaluateBC1(block, lo, hi, color0, color1, indices);
+
+    // Index 0 is the larger endpoint, hi
+    float weights[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        weights[i] = 1.0f - WEIGHTS[indices[i]];
+    }
+    if (refineEndpoints(block, 3, weights, lo, hi)) {
+        uint16_t refined0, refined1;
+        uint8_t refinedIndices[16];
+        const float refinedError = evaluateBC1(block, lo, hi, refined0, refined1, refinedIndices);
+        if (refinedError < error) {
+            color0 = refined0;
+            color1 = refined1;
+            memcpy(indices, refinedIndices, sizeof(indices));
+        }
+    }
+
+    uint32_t indexBits = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        indexBits |= static_cast<uint32_t>(indices[i]) << (2 * i);
+    }
+    memcpy(dst, &color0, 2);
+    memcpy(dst + 2, &color1, 2);
+    memcpy(dst + 4, &indexBits, 4);
+}
+
+// BC4
+// One channel; red0 > red1 selects the 8-value mode
+
+void encodeBC4(const Block &block, const uint32_t channel, uint8_t *dst) {
+    Block single{};
+    memcpy(single.channels[0], block.channels[channel], sizeof(single.channels[0]));
+
+    float minimum = 255.0f, maximum = 0.0f;
+    for (const float v: single.channels[0]) {
+        minimum = std::min(minimum, v);
+        maximum = std::max(maximum, v);
+    }
+    const uint32_t red0 = static_cast<uint32_t>(maximum);
+    const uint32_t red1 = static_cast<uint32_t>(minimum);
+
+    uint8_t indices[16] = {};
+    if (red0 > red1) {
+        Color palette[8] = {};
+        palette[0][0]    = static_cast<float>(red0);
+        palette[1][0]    = static_cast<float>(red1);
+        for (uint32_t k = 2; k < 8; ++k) {
+            palette[k][0] = static_cast<float>((8 - k) * red0 + (k - 1) * red1) / 7.0f;
+        }
+        selectIndices(single, 1, palette, 8, indices);
+    }
+
+    BlockWriter writer;
+    writer.write(red0, 8);
+    writer.write(red1, 8);
+    for (const uint8_t index: indices) {
+        writer.write(index, 3);
+    }
+    memcpy(dst, writer.words, 8);
+}
+
+// BC7
+// Mode 6: RGBA endpoints of 7 bits plus a p-bit each, and 4-bit indices
+
+struct BC7Endpoints {
+    uint32_t color[2][4];
+    uint32_t pBit[2];
+};
+
+// Picks the p-bit giving the endpoint the least error
+void quantizeBC7(const Color endpoint, uint32_t color[4], uint32_t &pBit) {
+    float bestError = FLT_MAX;
+    for (uint32_t p = 0; p < 2; ++p) {
+        uint32_t quantized[4];
+        float error = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c) {
+            quantized[c]     = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - static_cast<float>(p)) / 2.0f), 0l, 127l));
+            const float diff = static_cast<float>(quantized[c] << 1 | p) - endpoint[c];
+            error += diff * diff;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pBit      = p;
+            memcpy(color, quantized, sizeof(quantized));
+        }
+    }
+}
+
+float evaluateBC7(const Block &block, const Color lo, const Color hi, BC7Endpoints &endpoints, uint8_t indices[16]) {
+    quantizeBC7(lo, endpoints.color[0], endpoints.pBit[0]);
+    quantizeBC7(hi, endpoints.color[1], endpoints.pBit[1]);
+
+    Color palette[16];
+    for (uint32_t k = 0; k < 16; ++k) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            const uint32_t e0 = endpoints.color[0][c] << 1 | endpoints.pBit[0];
+            const uint32_t e1 = endpoints.color[1][c] << 1 | endpoints.pBit[1];
+            palette[k][c]     = static_cast<float>(((64 - BC7_WEIGHTS[k]) * e0 + BC7_WEIGHTS[k] * e1 + 32) >> 6);
+        }
+    }
+    return selectIndices(block, 4, palette, 16, indices);
+}
+
+void encodeBC7(const Block &block, uint8_t *dst) {
+    Color lo, hi;
+    fitPrincipalAxis(block, 4, lo, hi);
+
+    BC7Endpoints endpoints;
+    uint8_t indices[16];
+    const float error = evaluateBC7(block, lo, hi, endpoints, indices);
+
+    float weights[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        weights[i] = static_cast<float>(BC7_WEIGHTS[indices[i]]) / 64.0f;
+    }
+    if (refineEndpoints(block, 4, weights, lo, hi)) {
+        BC7Endpoints refined;
+        uint8_t refinedIndices[16];
+        const float refinedError = evaluateBC7(block, lo, hi, refined, refinedIndices);
+        if (refinedError < error) {
+            endpoints = refined;
+            memcpy(indices, refinedIndices, sizeof(indices));
+        }
+    }
+
+    // The first index is stored without its top bit, which must be 0
+    if (indices[0] & 8) {
+        std::swap(endpoints.color[0], endpoints.color[1]);
+        std::swap(endpoints.pBit[0], endpoints.pBit[1]);
+        for (uint8_t &index: indices) {
+            index = 15 - index;
+        }
+    }
+
+    BlockWriter writer;
+    writer.write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c) {
+        writer.write(endpoints.color[0][c], 7);
+        writer.write(endpoints.color[1][c], 7);
+    }
+    writer.write(endpoints.pBit[0], 1);
+    writer.write(endpoints.pBit[1], 1);
+    writer.write(indices[0], 3);
+    for (uint32_t i = 1; i < 16; ++i) {
+        writer.write(indices[i], 4);
+    }
+    memcpy(dst, writer.words, 16);
+}
+
+}// namespace
+
+VkFormat blockFormat(const TextureUsage usage) {
+    switch (usage) {
+        case TextureUsage::Normal:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureUsage::Mask:
+            return VK_FORMAT_BC4_UNORM_BLOCK;
+        default:
+            return VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+}
+
+void generateMipChain(uint8_t *levels, const VkExtent3D extent, const uint32_t levelCount) {
+    VkDeviceSize srcOffset = 0;
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        const uint32_t srcWidth      = std::max(extent.width >> (level - 1), 1u);
+        const uint32_t srcHeight     = std::max(extent.height >> (level - 1), 1u);
+        const uint32_t dstWidth      = std::max(extent.width >> level, 1u);
+        const uint32_t dstHeight     = std::max(extent.height >> level, 1u);
+        const VkDeviceSize dstOffset = srcOffset + jvk::mipLevelSize(VK_FORMAT_R8G8B8A8_UNORM, extent, level - 1);
+
+        const uint8_t *src = levels + srcOffset;
+        uint8_t *dst       = levels + dstOffset;
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            // Odd sizes repeat the last row & column
+            const uint32_t y0 = std::min(2 * y, srcHeight - 1);
+            const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                const uint32_t x0 = std::min(2 * x, srcWidth - 1);
+                const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+                for (uint32_t c = 0; c < 4; ++c) {
+                    const uint32_t sum = src[(y0 * srcWidth + x0) * 4 + c] + src[(y0 * srcWidth + x1) * 4 + c] +
+                                         src[(y1 * srcWidth + x0) * 4 + c] + src[(y1 * srcWidth + x1) * 4 + c];
+                    dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        srcOffset = dstOffset;
+    }
+}
+
+void encodeImage(JobSystem &jobs, const VkFormat format, const uint8_t *rgba, const VkExtent2D extent, uint8_t *dst) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            break;
+        default:
+            fmt::println("Cannot encode {}", string_VkFormat(format));
+            abort();
+    }
+
+    const uint32_t blockSize = jvk::formatBlock(format).size;
+    const uint32_t blocksX   = (extent.width + 3) / 4;
+    const uint32_t blocksY   = (extent.height + 3) / 4;
+
+    jobs.parallelFor(blocksY, JVK_ENCODE_ROWS_PER_JOB, [&](const uint32_t first, const uint32_t last) {
+        Block block;
+        for (uint32_t y = first; y < last; ++y) {
+            for (uint32_t x = 0; x < blocksX; ++x) {
+                readBlock(rgba, extent, x, y, block);
+
+                uint8_t *out = dst + (static_cast<size_t>(y) * blocksX + x) * blockSize;
+                switch (format) {
+                    case VK_FORMAT_BC4_UNORM_BLOCK:
+                        encodeBC4(block, 0, out);
+                        break;
+                    case VK_FORMAT_BC5_UNORM_BLOCK:
+                        encodeBC4(block, 0, out);
+                        encodeBC4(block, 1, out + 8);
+                        break;
+                    case VK_FORMAT_BC7_UNORM_BLOCK:
+                    case VK_FORMAT_BC7_SRGB_BLOCK:
+                        encodeBC7(block, out);
+                        break;
+                    default:
+                        encodeBC1(block, out);
+                        break;
+                }
+            }
+        }
+    });
+}
+
+std::vector<uint8_t> encodeMipChain(JobSystem &jobs, const VkFormat format, const uint8_t *levels, const VkExtent3D extent, const uint32_t levelCount) {
+    std::vector<uint8_t> encoded(jvk::mipChainSize(format, extent, levelCount));
+
+    VkDeviceSize srcOffset = 0;
+    VkDeviceSize dstOffset = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const VkExtent2D levelExtent = {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+        encodeImage(jobs, format, levels + srcOffset, levelExtent, encoded.data() + dstOffset);
+
+        srcOffset += jvk::mipLevelSize(VK_FORMAT_R8G8B8A8_UNORM, extent, level);
+        dstOffset += jvk::mipLevelSize(format, extent, level);
+    }
+    return encoded;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <jvk.hpp>
+
+class JobSystem;
+
+// Block rows of a level encoded per job
+constexpr uint32_t JVK_ENCODE_ROWS_PER_JOB = 4;
+
+// How a texture is sampled, which decides the block format it is compressed to
+enum class TextureUsage {
+    Color,
+    Normal,// Tangent-space normals: x & y are kept, z is reconstructed
+    Mask,  // Single-channel data (occlusion, masks, heights)
+};
+
+/**
+ * Block format for an RGBA8 texture: BC5 for normal maps, BC4 for
+ * single-channel data and BC7 for everything else.
+ */
+VkFormat blockFormat(TextureUsage usage);
+
+/**
+ * Fills levels 1 to levelCount - 1 of a packed RGBA8 mip chain, whose level
+ * 0 holds the image, by box-filtering each level down from the previous one
+ * (like the blits of jvk::generateMipmaps).
+ */
+void generateMipChain(uint8_t *levels, VkExtent3D extent, uint32_t levelCount);
+
+/**
+ * Encodes an RGBA8 image into format (BC1, BC4, BC5 or BC7, UNORM or SRGB);
+ * dst holds jvk::mipLevelSize() bytes. Block rows are encoded in parallel.
+ *
+ * BC1 is always opaque, BC4 & BC5 take red (and green) and BC7 only uses
+ * mode 6 (one subset, RGBA endpoints, 16 weights). Endpoints are fitted to
+ * the principal axis of the block and refined by least squares; picking the
+ * weights uses AVX when compiled with it, SSE otherwise, with a scalar
+ * fallback.
+ */
+void encodeImage(JobSystem &jobs, VkFormat format, const uint8_t *rgba, VkExtent2D extent, uint8_t *dst);
+
+// Encodes each level of a packed RGBA8 mip chain; returns the packed levels in format
+std::vector<uint8_t> encodeMipChain(JobSystem &jobs, VkFormat format, const uint8_t *levels, VkExtent3D extent, uint32_t levelCount);
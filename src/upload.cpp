@@ -0,0 +1,403 @@
+#include <upload.hpp>
+#include <engine.hpp>
+
+#include <jvk/init.hpp>
+#include <jvk/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+static VkImageMemoryBarrier2 layoutBarrier(VkImage image, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+                                           const VkPipelineStageFlags2 srcStage, const VkAccessFlags2 srcAccess,
+                                           const VkPipelineStageFlags2 dstStage, const VkAccessFlags2 dstAccess) {
+    VkImageMemoryBarrier2 barrier{};
+    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.pNext               = nullptr;
+    barrier.srcStageMask        = srcStage;
+    barrier.srcAccessMask       = srcAccess;
+    barrier.dstStageMask        = dstStage;
+    barrier.dstAccessMask       = dstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.oldLayout           = oldLayout;
+    barrier.newLayout           = newLayout;
+    barrier.subresourceRange    = jvk::init::imageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT);
+    barrier.image               = image;
+    return barrier;
+}
+
+static void pipelineBarrier(VkCommandBuffer cmd, const std::span<const VkBufferMemoryBarrier2> bufferBarriers, const std::span<const VkImageMemoryBarrier2> imageBarriers) {
+    VkDependencyInfo dependencyInfo{};
+    dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.pNext                    = nullptr;
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers    = bufferBarriers.data();
+    dependencyInfo.imageMemoryBarrierCount  = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers     = imageBarriers.data();
+    vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+}
+
+// Release (transfer side) or acquire (graphics side) half of an ownership transfer
+static VkBufferMemoryBarrier2 ownershipBarrier(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size, const uint32_t srcFamily, const uint32_t dstFamily, const bool release) {
+    VkBufferMemoryBarrier2 barrier{};
+    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier.pNext               = nullptr;
+    barrier.srcStageMask        = release ? VK_PIPELINE_STAGE_2_COPY_BIT : VK_PIPELINE_STAGE_2_NONE;
+    barrier.srcAccessMask       = release ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE;
+    barrier.dstStageMask        = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    barrier.dstAccessMask       = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.buffer              = buffer;
+    barrier.offset              = offset;
+    barrier.size                = size;
+    return barrier;
+}
+
+static VkImageMemoryBarrier2 ownershipBarrier(VkImage image, const bool mipmapped, const uint32_t srcFamily, const uint32_t dstFamily, const bool release) {
+    VkImageMemoryBarrier2 barrier{};
+    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.pNext               = nullptr;
+    barrier.srcStageMask        = release ? VK_PIPELINE_STAGE_2_COPY_BIT : VK_PIPELINE_STAGE_2_NONE;
+    barrier.srcAccessMask       = release ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE;
+    barrier.dstStageMask        = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    barrier.dstAccessMask       = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    // Both halves describe the same transition; it happens once
+    barrier.oldLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout        = mipmapped ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.subresourceRange = jvk::init::imageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT);
+    barrier.image            = image;
+    return barrier;
+}
+
+void UploadManager::init(JVKEngine *engine, const jvk::Queue &transferQueue, const uint32_t graphicsFamily) {
+    engine_         = engine;
+    queue_          = transferQueue;
+    graphicsFamily_ = graphicsFamily;
+
+    VK_CHECK(timeline_.init(engine->ctx_));
+    VK_CHECK(pool_.init(engine->ctx_, queue_.family, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+    for (Batch &batch: batches_) {
+        VK_CHECK(pool_.allocateCommandBuffer(&batch.cmd));
+    }
+
+    ring_ = engine->createBuffer(JVK_STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+    head_ = 0;
+    tail_ = 0;
+}
+
+void UploadManager::destroy() {
+    for (Batch &batch: batches_) {
+        for (const jvk::Buffer &buffer: batch.dedicatedStaging) {
+            engine_->destroyBuffer(buffer);
+        }
+        batch.dedicatedStaging.clear();
+    }
+    for (const jvk::Buffer &buffer: pendingStaging_) {
+        engine_->destroyBuffer(buffer);
+    }
+    pendingStaging_.clear();
+    inFlight_.clear();
+
+    engine_->destroyBuffer(ring_);
+    pool_.destroy();
+    timeline_.destroy();
+}
+
+uint64_t UploadManager::uploadBuffer(VkBuffer dst, const VkDeviceSize dstOffset, const void *data, const VkDeviceSize size) {
+    if (size == 0) return timeline_.submitted;
+
+    VkBuffer staging;
+    const VkDeviceSize srcOffset = stage(data, size, staging);
+
+    VkBufferCopy copy{};
+    copy.srcOffset = srcOffset;
+    copy.dstOffset = dstOffset;
+    copy.size      = size;
+    vkCmdCopyBuffer(record(), staging, dst, 1, &copy);
+
+    if (dedicatedQueue()) {
+        pendingBuffers_.push_back({dst, dstOffset, size});
+    }
+    return timeline_.submitted + 1;
+}
+
+uint64_t UploadManager::uploadImage(const jvk::Image &image, const void *data, const VkDeviceSize size, const bool mipmapped) {
+    VkBuffer staging;
+    const VkDeviceSize srcOffset = stage(data, size, staging);
+    record();
+
+    // Recorded on flush, so the batch's layout transitions share barriers
+    pendingImageCopies_.push_back({image.image, image.imageFormat, image.imageExtent, staging, srcOffset, mipmapped, 1});
+    return timeline_.submitted + 1;
+}
+
+uint64_t UploadManager::uploadImageLevels(const jvk::Image &image, const void *data, const VkDeviceSize size, const uint32_t levelCount) {
+    VkBuffer staging;
+    const VkDeviceSize srcOffset = stage(data, size, staging);
+    record();
+
+    pendingImageCopies_.push_back({image.image, image.imageFormat, image.imageExtent, staging, srcOffset, false, levelCount});
+    return timeline_.submitted + 1;
+}
+
+void UploadManager::beginBatch() {
+    batchDepth_++;
+}
+
+void UploadManager::endBatch() {
+    assert(batchDepth_ > 0);
+    if (--batchDepth_ == 0) {
+        flush();
+    }
+}
+
+void UploadManager::recordImageCopies(VkCommandBuffer cmd) {
+    if (pendingImageCopies_.empty()) return;
+
+    // TRANSFER DST
+    std::vector<VkImageMemoryBarrier2> barriers;
+    barriers.reserve(pendingImageCopies_.size());
+    for (const ImageCopy &copy: pendingImageCopies_) {
+        barriers.push_back(layoutBarrier(copy.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+                                         VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+    }
+    pipelineBarrier(cmd, {}, barriers);
+
+    // COPIES
+    // One region per level; levels are packed back to back in staging
+    std::vector<VkBufferImageCopy> copyRegions;
+    for (const ImageCopy &copy: pendingImageCopies_) {
+        copyRegions.clear();
+        VkDeviceSize levelOffset = copy.srcOffset;
+        for (uint32_t level = 0; level < copy.levelCount; ++level) {
+            VkBufferImageCopy copyRegion{};
+            copyRegion.bufferOffset      = levelOffset;
+            copyRegion.bufferRowLength   = 0;
+            copyRegion.bufferImageHeight = 0;
+
+            copyRegion.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel       = level;
+            copyRegion.imageSubresource.baseArrayLayer = 0;
+            copyRegion.imageSubresource.layerCount     = 1;
+            copyRegion.imageExtent                     = {std::max(copy.extent.width >> level, 1u), std::max(copy.extent.height >> level, 1u), std::max(copy.extent.depth >> level, 1u)};
+            copyRegions.push_back(copyRegion);
+
+            levelOffset += jvk::mipLevelSize(copy.format, copy.extent, level);
+        }
+
+        vkCmdCopyBufferToImage(cmd, copy.staging, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+    }
+
+    // SHADER READ
+    // Released to the graphics family instead when copies run on their own queue
+    barriers.clear();
+    for (const ImageCopy &copy: pendingImageCopies_) {
+        const VkExtent2D extent = {copy.extent.width, copy.extent.height};
+        if (dedicatedQueue()) {
+            pendingImages_.push_back({copy.image, extent, copy.mipmapped});
+        } else if (copy.mipmapped) {
+            jvk::generateMipmaps(cmd, copy.image, extent);
+        } else {
+            barriers.push_back(layoutBarrier(copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                             VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                             VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT));
+        }
+    }
+    if (!barriers.empty()) {
+        pipelineBarrier(cmd, {}, barriers);
+    }
+
+    pendingImageCopies_.clear();
+}
+
+void UploadManager::flush() {
+    if (!recording_) return;
+
+    Batch &batch = batches_[next_];
+    recordImageCopies(batch.cmd);
+
+    // RELEASE
+    if (!pendingBuffers_.empty() || !pendingImages_.empty()) {
+        std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+        bufferBarriers.reserve(pendingBuffers_.size());
+        for (const BufferTransfer &transfer: pendingBuffers_) {
+            bufferBarriers.push_back(ownershipBarrier(transfer.buffer, transfer.offset, transfer.size, queue_.family, graphicsFamily_, true));
+        }
+        std::vector<VkImageMemoryBarrier2> imageBarriers;
+        imageBarriers.reserve(pendingImages_.size());
+        for (const ImageTransfer &transfer: pendingImages_) {
+            imageBarriers.push_back(ownershipBarrier(transfer.image, transfer.mipmapped, queue_.family, graphicsFamily_, true));
+        }
+
+        pipelineBarrier(batch.cmd, bufferBarriers, imageBarriers);
+
+        readyBuffers_.insert(readyBuffers_.end(), pendingBuffers_.begin(), pendingBuffers_.end());
+        readyImages_.insert(readyImages_.end(), pendingImages_.begin(), pendingImages_.end());
+        pendingBuffers_.clear();
+        pendingImages_.clear();
+    }
+
+    VK_CHECK(batch.cmd.end());
+
+    // SUBMIT
+    batch.value            = timeline_.nextValue();
+    batch.ringEnd          = head_;
+    batch.dedicatedStaging = std::move(pendingStaging_);
+    pendingStaging_.clear();
+    chunkCapacity_ = 0;
+
+    VkCommandBufferSubmitInfo cmdInfo = batch.cmd.submitInfo();
+    VkSemaphoreSubmitInfo signalInfo  = timeline_.submitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, batch.value);
+    VK_CHECK(queue_.submit(&cmdInfo, {}, {&signalInfo, 1}));
+
+    inFlight_.push_back(next_);
+    next_      = (next_ + 1) % JVK_UPLOAD_BATCHES;
+    recording_ = false;
+    stats_.batchCount++;
+
+    retireCompleted();
+}
+
+void UploadManager::recordGraphicsWork(VkCommandBuffer cmd) {
+    if (readyBuffers_.empty() && readyImages_.empty()) return;
+
+    // ACQUIRE
+    std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+    bufferBarriers.reserve(readyBuffers_.size());
+    for (const BufferTransfer &transfer: readyBuffers_) {
+        bufferBarriers.push_back(ownershipBarrier(transfer.buffer, transfer.offset, transfer.size, queue_.family, graphicsFamily_, false));
+    }
+    std::vector<VkImageMemoryBarrier2> imageBarriers;
+    imageBarriers.reserve(readyImages_.size());
+    for (const ImageTransfer &transfer: readyImages_) {
+        imageBarriers.push_back(ownershipBarrier(transfer.image, transfer.mipmapped, queue_.family, graphicsFamily_, false));
+    }
+
+    pipelineBarrier(cmd, bufferBarriers, imageBarriers);
+
+    // MIPMAPS
+    // Blits need a graphics queue
+    for (const ImageTransfer &transfer: readyImages_) {
+        if (transfer.mipmapped) {
+            jvk::generateMipmaps(cmd, transfer.image, transfer.extent);
+        }
+    }
+
+    readyBuffers_.clear();
+    readyImages_.clear();
+}
+
+void UploadManager::collectStats(Stats &stats) {
+    stats  = stats_;
+    stats_ = {};
+}
+
+VkDeviceSize UploadManager::stage(const void *data, const VkDeviceSize size, VkBuffer &buffer) {
+    stats_.byteCount += size;
+
+    // Too large for the ring
+    if (size + JVK_STAGING_ALIGNMENT > JVK_STAGING_RING_SIZE) {
+        jvk::Buffer staging = engine_->createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        memcpy(staging.info.pMappedData, data, size);
+        pendingStaging_.push_back(staging);
+        buffer = staging;
+        return 0;
+    }
+
+    VkDeviceSize offset;
+    if (!allocateRing(size, offset)) {
+        retireCompleted();
+    }
+    while (!allocateRing(size, offset)) {
+        // A batch is submitted as a whole: spill into a chunk instead of waiting
+        if (batchDepth_ > 0) {
+            return stageChunk(data, size, buffer);
+        }
+
+        // Full: wait for the oldest batch, submitting the one being recorded if it holds all the space
+        if (inFlight_.empty()) {
+            flush();
+        }
+        retireOldest();
+    }
+
+    memcpy(static_cast<char *>(ring_.info.pMappedData) + offset, data, size);
+    buffer = ring_;
+    return offset;
+}
+
+bool UploadManager::allocateRing(const VkDeviceSize size, VkDeviceSize &offset) {
+    // Empty: restart at the beginning, so any size up to the ring's fits
+    if (head_ == tail_) {
+        head_ = tail_ = jvk::alignUp(head_, JVK_STAGING_RING_SIZE);
+    }
+
+    uint64_t position = jvk::alignUp(head_, JVK_STAGING_ALIGNMENT);
+    // Never straddle the end of the ring
+    if (position % JVK_STAGING_RING_SIZE + size > JVK_STAGING_RING_SIZE) {
+        position = jvk::alignUp(position, JVK_STAGING_RING_SIZE);
+    }
+
+    if (position + size - tail_ > JVK_STAGING_RING_SIZE) return false;
+
+    offset = position % JVK_STAGING_RING_SIZE;
+    head_  = position + size;
+    return true;
+}
+
+VkDeviceSize UploadManager::stageChunk(const void *data, const VkDeviceSize size, VkBuffer &buffer) {
+    VkDeviceSize offset = jvk::alignUp(chunkUsed_, JVK_STAGING_ALIGNMENT);
+    if (offset + size > chunkCapacity_) {
+        // Released with the batch, like dedicated staging buffers
+        chunk_ = engine_->createBuffer(JVK_STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        pendingStaging_.push_back(chunk_);
+        chunkCapacity_ = JVK_STAGING_RING_SIZE;
+        offset         = 0;
+    }
+
+    memcpy(static_cast<char *>(chunk_.info.pMappedData) + offset, data, size);
+    chunkUsed_ = offset + size;
+    buffer     = chunk_;
+    return offset;
+}
+
+VkCommandBuffer UploadManager::record() {
+    if (!recording_) {
+        // All batches in flight; the next one is the oldest
+        if (inFlight_.size() == JVK_UPLOAD_BATCHES) {
+            retireOldest();
+        }
+
+        const Batch &batch = batches_[next_];
+        VK_CHECK(batch.cmd.reset());
+        VK_CHECK(batch.cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+        recording_ = true;
+    }
+    return batches_[next_].cmd;
+}
+
+void UploadManager::retireCompleted() {
+    if (inFlight_.empty()) return;
+
+    // Batches finish in submission order
+    const uint64_t completed = timeline_.value();
+    while (!inFlight_.empty() && batches_[inFlight_.front()].value <= completed) {
+        Batch &batch = batches_[inFlight_.front()];
+        tail_        = batch.ringEnd;
+        for (const jvk::Buffer &buffer: batch.dedicatedStaging) {
+            engine_->destroyBuffer(buffer);
+        }
+        batch.dedicatedStaging.clear();
+        inFlight_.pop_front();
+    }
+}
+
+void UploadManager::retireOldest() {
+    assert(!inFlight_.empty());
+    VK_CHECK(timeline_.wait(batches_[inFlight_.front()].value));
+    retireCompleted();
+}
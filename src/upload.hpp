@@ -0,0 +1,165 @@
+#pragma once
+
+#include <jvk.hpp>
+#include <jvk/buffer.hpp>
+#include <jvk/commands.hpp>
+#include <jvk/image.hpp>
+#include <jvk/queue.hpp>
+#include <jvk/semaphore.hpp>
+
+class JVKEngine;
+
+// Persistent staging ring; uploads that do not fit get a staging buffer of their own
+constexpr VkDeviceSize JVK_STAGING_RING_SIZE = 64ull * 1024 * 1024;
+// Staging offsets are aligned for any texel block size a copy may use
+constexpr VkDeviceSize JVK_STAGING_ALIGNMENT = 16;
+// Submitted batches in flight before the oldest one is waited on
+constexpr uint32_t JVK_UPLOAD_BATCHES = 4;
+
+/**
+ * Streams buffer & image data to the GPU without blocking.
+ *
+ * Data is copied into a persistently mapped staging ring and the copies are
+ * recorded into a batch, submitted on flush() to the transfer queue. Each
+ * batch signals the next value of the manager's timeline semaphore: upload
+ * functions return the value their batch will signal, and ring space is only
+ * reused once the batch that staged it has finished.
+ *
+ * Between beginBatch() and endBatch() nothing is submitted and the CPU
+ * never waits: once the ring is full, staging spills into temporary chunks
+ * and everything is submitted as one batch. Image copies are recorded when
+ * their batch is flushed, so all layout transitions of a batch share one
+ * barrier before and one after the copies.
+ *
+ * With a dedicated transfer queue family, uploads end with a release of the
+ * resource to the graphics family. The matching acquire (and, since blits
+ * need a graphics queue, mipmap generation) is recorded by
+ * recordGraphicsWork() into the next frame, which must wait on
+ * submittedValue().
+ */
+class UploadManager {
+public:
+    struct Stats {
+        uint32_t batchCount;
+        VkDeviceSize byteCount;
+    };
+
+    UploadManager() {};
+    UploadManager(UploadManager const &)            = delete;
+    UploadManager &operator=(UploadManager const &) = delete;
+
+    void init(JVKEngine *engine, const jvk::Queue &transferQueue, uint32_t graphicsFamily);
+    // The device must be idle
+    void destroy();
+
+    // Whether copies run on a queue family of their own
+    bool dedicatedQueue() const { return queue_.family != graphicsFamily_; }
+
+    // Copies size bytes of data into dst at dstOffset; returns the timeline value signaled once done
+    uint64_t uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void *data, VkDeviceSize size);
+    /**
+     * Copies data into mip 0 of image (created with TRANSFER_DST usage, and
+     * TRANSFER_SRC if mipmapped), which ends up SHADER_READ_ONLY_OPTIMAL with
+     * its mip chain generated if mipmapped. Returns the timeline value
+     * signaled once the copy is done.
+     */
+    uint64_t uploadImage(const jvk::Image &image, const void *data, VkDeviceSize size, bool mipmapped);
+    // Like uploadImage(), with levelCount prebuilt mips packed in data from mip 0 down
+    uint64_t uploadImageLevels(const jvk::Image &image, const void *data, VkDeviceSize size, uint32_t levelCount);
+
+    // Submits the batch being recorded, if any
+    void flush();
+    // Uploads until the matching endBatch() form a single submission; may nest
+    void beginBatch();
+    void endBatch();
+    // Records the graphics side of flushed uploads into cmd; its submission must wait on submittedValue()
+    void recordGraphicsWork(VkCommandBuffer cmd);
+
+    const jvk::TimelineSemaphore &timeline() const { return timeline_; }
+    // Value signaled by the last flushed batch
+    uint64_t submittedValue() const { return timeline_.submitted; }
+
+    // Activity since the last call, then resets the counters
+    void collectStats(Stats &stats);
+
+private:
+    struct Batch {
+        jvk::CommandBuffer cmd;
+        uint64_t value = 0;
+        // Ring position once the batch was flushed; everything before it is free once it finishes
+        uint64_t ringEnd = 0;
+        std::vector<jvk::Buffer> dedicatedStaging;
+    };
+
+    struct ImageCopy {
+        VkImage image;
+        VkFormat format;
+        VkExtent3D extent;
+        VkBuffer staging;
+        VkDeviceSize srcOffset;
+        // Generated after the copy if set, otherwise levelCount levels are copied
+        bool mipmapped;
+        uint32_t levelCount;
+    };
+
+    // Ranges & images handed from the transfer to the graphics family
+    struct BufferTransfer {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+    // Mipmapped images stay TRANSFER_DST_OPTIMAL until the graphics family generates their mips
+    struct ImageTransfer {
+        VkImage image;
+        VkExtent2D extent;
+        bool mipmapped;
+    };
+
+    JVKEngine *engine_ = nullptr;
+    jvk::Queue queue_;
+    uint32_t graphicsFamily_ = 0;
+
+    jvk::TimelineSemaphore timeline_;
+    jvk::CommandPool pool_;
+    Batch batches_[JVK_UPLOAD_BATCHES];
+    uint32_t next_       = 0;
+    bool recording_      = false;
+    uint32_t batchDepth_ = 0;
+    // Image copies of the batch being recorded
+    std::vector<ImageCopy> pendingImageCopies_;
+    // Submitted, unfinished batches, oldest first
+    std::deque<uint32_t> inFlight_;
+
+    // STAGING RING
+    // head_ & tail_ only grow; the ring offset is their value modulo JVK_STAGING_RING_SIZE
+    jvk::Buffer ring_;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    // Staging buffers of the batch being recorded: uploads too large for the ring & chunks
+    std::vector<jvk::Buffer> pendingStaging_;
+    // Chunk that staging spills into while batching, once the ring is full
+    jvk::Buffer chunk_;
+    VkDeviceSize chunkUsed_     = 0;
+    VkDeviceSize chunkCapacity_ = 0;
+
+    // OWNERSHIP TRANSFERS
+    // Released when the batch being recorded is flushed, then ready to be acquired
+    std::vector<BufferTransfer> pendingBuffers_;
+    std::vector<ImageTransfer> pendingImages_;
+    std::vector<BufferTransfer> readyBuffers_;
+    std::vector<ImageTransfer> readyImages_;
+
+    Stats stats_{};
+
+    // Copies data into staging memory; returns the offset to copy from in buffer
+    VkDeviceSize stage(const void *data, VkDeviceSize size, VkBuffer &buffer);
+    // Claims ring space without waiting; false if the ring is full
+    bool allocateRing(VkDeviceSize size, VkDeviceSize &offset);
+    VkDeviceSize stageChunk(const void *data, VkDeviceSize size, VkBuffer &buffer);
+    void recordImageCopies(VkCommandBuffer cmd);
+    // Command buffer of the batch being recorded, beginning one if needed
+    VkCommandBuffer record();
+    // Frees the ring space & staging buffers of finished batches; retireOldest() waits for one
+    void retireCompleted();
+    void retireOldest();
+};